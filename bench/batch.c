@@ -0,0 +1,106 @@
+#define _POSIX_C_SOURCE 200809L
+#define LIBJSON_IMPLEMENTATION
+#include "libjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Measures how the throughput of json_batch_loadbuffer and json_loadbuffer_parallel scales with the number of threads
+// on generated records
+
+#define RECORDS 200000
+#define ROUNDS	5
+
+char* names[] = {"Emma",   "Olivia", "Ava",		"Isabella", "Sophia",	 "Charlotte", "Mia",	"Amelia",
+				 "Harper", "Evelyn", "Abigail", "Emily",	"Elizabeth", "Mila",	  "Ella",	"Avery",
+				 "Sofia",  "Camila", "Liam",	"Noah",		"William",	 "James",	  "Oliver", "Benjamin",
+				 "Elijah", "Lucas",	 "Mason",	"Logan",	"Alexander", "Ethan",	  "Jacob",	"Michael",
+				 "Daniel", "Henry",	 "Jackson", "Sebastian"};
+
+JSON* person_create(size_t depth)
+{
+	JSON* person = json_create_object();
+	json_add_member(person, "name", json_create_string(names[rand() % sizeof(names) / sizeof(*names)]));
+	json_add_member(person, "age", json_create_number(rand() % 10 + 10));
+	json_add_member(person, "balance", json_create_number(rand() / (double)RAND_MAX * 1000));
+	if (depth > 0)
+	{
+		JSON* friends = json_create_array();
+		json_add_member(person, "friends", friends);
+		for (size_t i = 0; i < 2; i++)
+			json_add_element(friends, person_create(depth - 1));
+	}
+	return person;
+}
+
+struct Buffer
+{
+	char* data;
+	size_t length;
+	size_t size;
+};
+
+// JSONWriteFn collecting the records in memory
+int buffer_write(void* ctx, const char* data, size_t len)
+{
+	struct Buffer* buf = ctx;
+	if (buf->length + len > buf->size)
+	{
+		buf->size = (buf->length + len) * 2;
+		buf->data = realloc(buf->data, buf->size);
+	}
+	memcpy(buf->data + buf->length, data, len);
+	buf->length += len;
+	return 0;
+}
+
+// Wall clock time, since the threads add up in clock()
+double now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main()
+{
+	struct Buffer buf = {NULL, 0, 0};
+	JSONLinesWriter* writer = json_lines_writer_create(buffer_write, &buf);
+	for (int i = 0; i < RECORDS; i++)
+	{
+		JSON* person = person_create(rand() % 3);
+		json_lines_write(writer, person);
+		json_destroy(person);
+	}
+	json_lines_writer_close(writer);
+	printf("%d records, %.1f MB\n", RECORDS, buf.length / 1e6);
+
+	for (int threads = 1; threads <= 16; threads *= 2)
+	{
+		double start = now();
+		for (int round = 0; round < ROUNDS; round++)
+			json_batch_destroy(json_batch_loadbuffer(buf.data, buf.length, threads));
+		double elapsed = now() - start;
+		printf("batch    %2d threads %8.1f MB/s\n", threads, buf.length * (double)ROUNDS / elapsed / 1e6);
+	}
+
+	// The same records as the elements of one array, where the last newline becomes the closing bracket
+	char* array = malloc(buf.length + 1);
+	array[0] = '[';
+	memcpy(array + 1, buf.data, buf.length);
+	for (size_t i = 1; i < buf.length; i++)
+		if (array[i] == '\n')
+			array[i] = ',';
+	array[buf.length] = ']';
+	for (int threads = 1; threads <= 16; threads *= 2)
+	{
+		double start = now();
+		for (int round = 0; round < ROUNDS; round++)
+			json_destroy(json_loadbuffer_parallel(array, buf.length + 1, threads));
+		double elapsed = now() - start;
+		printf("parallel %2d threads %8.1f MB/s\n", threads, buf.length * (double)ROUNDS / elapsed / 1e6);
+	}
+	free(array);
+	free(buf.data);
+}
@@ -0,0 +1,142 @@
+#define LIBJSON_IMPLEMENTATION
+#include "libjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Compares json_dtoa against the fixed precision formatter it replaced
+
+#define COUNT 1000000
+#define ROUNDS 5
+
+// The previous formatter, printing at most precision digits after the point
+static int legacy_ftos(double num, char* buf, int precision)
+{
+	if (isinf(num))
+	{
+		if (num < 0)
+			*buf++ = '-';
+		*buf++ = 'i';
+		*buf++ = 'n';
+		*buf++ = 'f';
+		*buf++ = '\0';
+		return num < 0 ? 4 : 3;
+	}
+
+	// Save the sign and remove it from num
+	int neg = num < 0;
+	if (neg)
+		num *= -1;
+	// Shift decimal to precision places to an int
+	size_t a = num * pow(10, precision + 1);
+
+	// Round initially
+	if (a % 10 >= 5)
+		a += 10;
+	a /= 10;
+
+	int dec_pos = precision;
+
+	// Carried the one, need to round once more
+	while (a % 10 == 0 && a && a > num)
+	{
+		if (a % 10 >= 5)
+			a += 10;
+		a /= 10;
+		dec_pos--;
+	}
+
+	int base = 10;
+	char numerals[17] = {"0123456789ABCDEF"};
+
+	// Return and write one character if float == 0 to precision accuracy
+	if (a == 0)
+	{
+		*buf++ = '0';
+		*buf = '\0';
+		return 1;
+	}
+
+	size_t digitcount = log10(a) + 1;
+	size_t buf_index = digitcount + neg + (dec_pos >= digitcount ? dec_pos - digitcount + 1 : 0) + (dec_pos ? 1 : 0);
+	int return_value = buf_index;
+
+	buf[buf_index] = '\0';
+	while (buf_index)
+	{
+		buf[--buf_index] = numerals[a % base];
+		if (dec_pos == 1)
+			buf[--buf_index] = '.';
+		dec_pos--;
+		a /= base;
+	}
+	if (neg)
+		*buf = '-';
+	return return_value;
+}
+
+double seconds(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// Formats all numbers ROUNDS times and prints the time per number
+void bench(const char* name, const double* numbers, int (*format)(double, char*))
+{
+	char buf[128];
+	size_t bytes = 0;
+	clock_t start = clock();
+	for (int round = 0; round < ROUNDS; round++)
+	{
+		for (size_t i = 0; i < COUNT; i++)
+			bytes += format(numbers[i], buf);
+	}
+	double elapsed = seconds(start);
+	printf("%-24s %8.2f ns/number %8.2f MB/s\n", name, elapsed * 1e9 / (COUNT * ROUNDS), bytes / elapsed / 1e6);
+}
+
+int format_legacy(double num, char* buf)
+{
+	return legacy_ftos(num, buf, 5);
+}
+
+int format_dtoa(double num, char* buf)
+{
+	return json_dtoa(num, buf);
+}
+
+int format_printf(double num, char* buf)
+{
+	return snprintf(buf, 128, "%.17g", num);
+}
+
+void run(const char* corpus, const double* numbers)
+{
+	printf("%s\n", corpus);
+	bench("  legacy json_ftos", numbers, format_legacy);
+	bench("  json_dtoa", numbers, format_dtoa);
+	bench("  snprintf %.17g", numbers, format_printf);
+}
+
+int main()
+{
+	double* numbers = malloc(COUNT * sizeof *numbers);
+
+	// Sensor readings with a few decimals, as in a telemetry time series
+	srand(1);
+	for (size_t i = 0; i < COUNT; i++)
+		numbers[i] = (rand() % 100000) / 100.0;
+	run("readings", numbers);
+
+	// Integral values such as counters and timestamps
+	for (size_t i = 0; i < COUNT; i++)
+		numbers[i] = 1600000000.0 + i;
+	run("integers", numbers);
+
+	// Arbitrary doubles with 17 significant digits
+	for (size_t i = 0; i < COUNT; i++)
+		numbers[i] = rand() / (double)RAND_MAX * 1000;
+	run("random", numbers);
+
+	free(numbers);
+}
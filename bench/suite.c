@@ -0,0 +1,375 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Measures loading, writing, member lookup and destruction on generated corpora of several kinds and sizes
+// Prints MB/s, ns per node, and the allocations of one round of every operation as a table, or with --json as one json
+// record per line, so that the results of runs can be kept and compared
+// The corpora are generated from a fixed seed and are the same on every run and platform
+
+// Every allocation made by the library is counted
+size_t allocations = 0;
+
+void* counted_malloc(size_t size)
+{
+	allocations++;
+	return malloc(size);
+}
+
+void* counted_realloc(void* ptr, size_t size)
+{
+	allocations++;
+	return realloc(ptr, size);
+}
+
+#define JSON_MALLOC(s)	   counted_malloc(s)
+#define JSON_REALLOC(p, s) counted_realloc(p, s)
+#define LIBJSON_IMPLEMENTATION
+#include "libjson.h"
+
+// The input processed by every operation adds up to at least this many bytes, in at least MIN_ROUNDS rounds
+#define BENCH_BYTES (64 << 20)
+#define MIN_ROUNDS	3
+
+const size_t sizes[] = {64 << 10, 1 << 20, 16 << 20};
+
+// xorshift64, since rand() differs between platforms
+uint64_t seed;
+
+uint64_t next()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+size_t below(size_t n)
+{
+	return next() % n;
+}
+
+struct Buffer
+{
+	char* data;
+	size_t length;
+	size_t size;
+};
+
+void append(struct Buffer* buf, const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	int len = vsnprintf(NULL, 0, fmt, args);
+	va_end(args);
+	if (buf->length + len + 1 > buf->size)
+	{
+		buf->size = (buf->length + len + 1) * 2;
+		buf->data = realloc(buf->data, buf->size);
+	}
+	va_start(args, fmt);
+	vsnprintf(buf->data + buf->length, len + 1, fmt, args);
+	va_end(args);
+	buf->length += len;
+}
+
+const char* words[] = {"request", "failed",	  "user",  "session", "timeout", "cache", "miss",	  "retry",
+					   "upstream", "latency", "queue", "worker",  "token",	 "query", "rejected", "accepted"};
+
+const char* names[] = {"Emma",   "Olivia", "Ava",		"Isabella", "Sophia",	 "Charlotte", "Mia",	"Amelia",
+					   "Harper", "Evelyn", "Abigail", "Emily",	"Elizabeth", "Mila",	  "Ella",	"Avery",
+					   "Sofia",  "Camila", "Liam",	"Noah",		"William",	 "James",	  "Oliver", "Benjamin",
+					   "Elijah", "Lucas",	 "Mason",	"Logan",	"Alexander", "Ethan",	  "Jacob",	"Michael",
+					   "Daniel", "Henry",	 "Jackson", "Sebastian"};
+
+#define COUNT(a) (sizeof(a) / sizeof(*(a)))
+
+// An array of integers, decimals, and doubles of any magnitude
+void gen_numbers(struct Buffer* buf, size_t size)
+{
+	append(buf, "[");
+	while (buf->length < size)
+	{
+		if (buf->length > 1)
+			append(buf, ",");
+		switch (below(3))
+		{
+		case 0:
+			append(buf, "%lld", (long long)below(2000000000) - 1000000000);
+			break;
+		case 1:
+			append(buf, "%.2f", below(10000000) / 100.0);
+			break;
+		default:
+		{
+			double mantissa = (double)(next() >> 11) / (double)(1ull << 53);
+			append(buf, "%.17g", mantissa * (below(2) ? 1e-200 : 1e200) * (double)below(1000));
+		}
+		}
+	}
+	append(buf, "]");
+}
+
+// An array of log records, mostly strings, some with escape sequences
+void gen_logs(struct Buffer* buf, size_t size)
+{
+	const char* levels[] = {"debug", "info", "warn", "error"};
+	append(buf, "[");
+	while (buf->length < size)
+	{
+		if (buf->length > 1)
+			append(buf, ",");
+		append(buf, "{\"time\":\"2024-05-%02zuT%02zu:%02zu:%02zu.%03zuZ\",\"level\":\"%s\",\"service\":\"api-%zu\",",
+			   below(28) + 1, below(24), below(60), below(60), below(1000), levels[below(COUNT(levels))], below(16));
+		append(buf, "\"message\":\"");
+		for (size_t i = below(16) + 4; i > 0; i--)
+			append(buf, "%s%s", words[below(COUNT(words))], i == 1 ? "" : below(8) ? " " : "\\n\\t");
+		if (below(4) == 0)
+			append(buf, " \\\"caf\\u00e9\\\"");
+		append(buf, "\",\"user\":{\"id\":%zu,\"name\":\"%s\"}}", below(1000000), names[below(COUNT(names))]);
+	}
+	append(buf, "]");
+}
+
+// An array of objects and arrays nested 256 deep
+void gen_deep(struct Buffer* buf, size_t size)
+{
+	append(buf, "[");
+	while (buf->length < size)
+	{
+		if (buf->length > 1)
+			append(buf, ",");
+		for (int i = 0; i < 128; i++)
+			append(buf, "{\"next\":[");
+		append(buf, "%zu", below(1000));
+		for (int i = 0; i < 128; i++)
+			append(buf, "]}");
+	}
+	append(buf, "]");
+}
+
+// A single object with a member for every few bytes
+void gen_wide(struct Buffer* buf, size_t size)
+{
+	append(buf, "{");
+	for (size_t i = 0; buf->length < size; i++)
+	{
+		if (i)
+			append(buf, ",");
+		append(buf, "\"member_%zu\":", i);
+		switch (below(4))
+		{
+		case 0:
+			append(buf, "%zu", below(100000));
+			break;
+		case 1:
+			append(buf, "\"%s\"", words[below(COUNT(words))]);
+			break;
+		case 2:
+			append(buf, below(2) ? "true" : "false");
+			break;
+		default:
+			append(buf, "null");
+		}
+	}
+	append(buf, "}");
+}
+
+// A person with friends, like tests/gen.c
+void gen_person(struct Buffer* buf, size_t depth)
+{
+	append(buf, "{\"name\":\"%s\",\"age\":%zu,\"balance\":%.17g", names[below(COUNT(names))], below(10) + 10,
+		   (double)(next() >> 11) / (double)(1ull << 53) * 1000);
+	if (depth > 0)
+	{
+		append(buf, ",\"friends\":[");
+		for (size_t i = 0; i < 2; i++)
+		{
+			if (i)
+				append(buf, ",");
+			gen_person(buf, depth - 1);
+		}
+		append(buf, "]");
+	}
+	append(buf, "}");
+}
+
+void gen_people(struct Buffer* buf, size_t size)
+{
+	append(buf, "[");
+	while (buf->length < size)
+	{
+		if (buf->length > 1)
+			append(buf, ",");
+		gen_person(buf, below(4));
+	}
+	append(buf, "]");
+}
+
+struct Corpus
+{
+	const char* name;
+	void (*gen)(struct Buffer* buf, size_t size);
+};
+
+const struct Corpus corpora[] = {
+	{"numbers", gen_numbers}, {"logs", gen_logs}, {"deep", gen_deep}, {"wide", gen_wide}, {"people", gen_people}};
+
+// Wall clock time
+double now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+size_t count_nodes(JSON* object)
+{
+	size_t count = 1;
+	for (JSON* it = json_get_members(object); it; it = json_get_next(it))
+		count += count_nodes(it);
+	for (JSON* it = json_get_elements(object); it; it = json_get_next(it))
+		count += count_nodes(it);
+	return count;
+}
+
+// A member to look up by name in its object
+struct Lookup
+{
+	JSON* object;
+	const char* name;
+};
+
+// Collects every member of every object in the tree
+void collect_lookups(JSON* object, struct Lookup** lookups, size_t* count, size_t* capacity)
+{
+	for (JSON* it = json_get_members(object); it; it = json_get_next(it))
+	{
+		if (*count == *capacity)
+		{
+			*capacity = *capacity ? *capacity * 2 : 1024;
+			*lookups = realloc(*lookups, *capacity * sizeof(struct Lookup));
+		}
+		(*lookups)[(*count)++] = (struct Lookup){object, json_get_name(it)};
+		collect_lookups(it, lookups, count, capacity);
+	}
+	for (JSON* it = json_get_elements(object); it; it = json_get_next(it))
+		collect_lookups(it, lookups, count, capacity);
+}
+
+int json_output = 0;
+
+// Prints the result of an operation on a corpus
+// bytes is the input or output processed per round, 0 if MB/s doesn't apply, and count the nodes or lookups per round
+void report(const char* corpus, size_t size, const char* op, double seconds, size_t bytes, size_t count,
+			size_t allocs)
+{
+	double mbs = bytes / seconds / 1e6;
+	double ns = seconds * 1e9 / count;
+	if (json_output)
+	{
+		printf("{\"corpus\":\"%s\",\"size\":%zu,\"op\":\"%s\",\"seconds\":%.9f,\"bytes\":%zu,\"count\":%zu,", corpus,
+			   size, op, seconds, bytes, count);
+		if (bytes)
+			printf("\"mb_s\":%.1f,", mbs);
+		else
+			printf("\"mb_s\":null,");
+		printf("\"ns_node\":%.2f,\"allocs\":%zu}\n", ns, allocs);
+	}
+	else if (bytes)
+		printf("%-8s %6zuK %-11s %9.1f %9.2f %9zu\n", corpus, size >> 10, op, mbs, ns, allocs);
+	else
+		printf("%-8s %6zuK %-11s %9s %9.2f %9zu\n", corpus, size >> 10, op, "-", ns, allocs);
+	fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+	json_output = argc > 1 && strcmp(argv[1], "--json") == 0;
+	if (!json_output)
+		printf("%-8s %7s %-11s %9s %9s %9s\n", "corpus", "size", "op", "MB/s", "ns/node", "allocs");
+
+	for (size_t c = 0; c < COUNT(corpora); c++)
+	{
+		for (size_t s = 0; s < COUNT(sizes); s++)
+		{
+			seed = 0x9E3779B97F4A7C15ull + c;
+			struct Buffer buf = {NULL, 0, 0};
+			corpora[c].gen(&buf, sizes[s]);
+			const char* name = corpora[c].name;
+			size_t rounds = BENCH_BYTES / buf.length < MIN_ROUNDS ? MIN_ROUNDS : BENCH_BYTES / buf.length;
+
+			JSON* root = json_loadbuffer(buf.data, buf.length);
+			if (root == NULL)
+				return 1;
+			size_t nodes = count_nodes(root);
+			struct Lookup* lookups = NULL;
+			size_t lookup_count = 0, lookup_capacity = 0;
+			collect_lookups(root, &lookups, &lookup_count, &lookup_capacity);
+
+			// The fastest round of each operation is reported, which is the least disturbed by the rest of the system
+			double best[5] = {1e9, 1e9, 1e9, 1e9, 1e9};
+			size_t allocs[5] = {0};
+			size_t written = 0;
+			for (size_t round = 0; round < rounds; round++)
+			{
+				allocations = 0;
+				double start = now();
+				JSON* loaded = json_loadbuffer(buf.data, buf.length);
+				double elapsed = now() - start;
+				best[0] = elapsed < best[0] ? elapsed : best[0];
+				allocs[0] = allocations;
+
+				allocations = 0;
+				start = now();
+				JSONDoc* doc = json_doc_loadbuffer(buf.data, buf.length);
+				elapsed = now() - start;
+				best[1] = elapsed < best[1] ? elapsed : best[1];
+				allocs[1] = allocations;
+				json_doc_destroy(doc);
+
+				allocations = 0;
+				start = now();
+				char* str = json_tostring(root, JSON_COMPACT);
+				elapsed = now() - start;
+				best[2] = elapsed < best[2] ? elapsed : best[2];
+				allocs[2] = allocations;
+				written = strlen(str);
+				free(str);
+
+				allocations = 0;
+				size_t found = 0;
+				start = now();
+				for (size_t i = 0; i < lookup_count; i++)
+					found += json_get_member(lookups[i].object, lookups[i].name) != NULL;
+				elapsed = now() - start;
+				best[3] = elapsed < best[3] ? elapsed : best[3];
+				allocs[3] = allocations;
+				if (found != lookup_count)
+					return 1;
+
+				allocations = 0;
+				start = now();
+				json_destroy(loaded);
+				elapsed = now() - start;
+				best[4] = elapsed < best[4] ? elapsed : best[4];
+				allocs[4] = allocations;
+			}
+
+			report(name, sizes[s], "load", best[0], buf.length, nodes, allocs[0]);
+			report(name, sizes[s], "doc_load", best[1], buf.length, nodes, allocs[1]);
+			report(name, sizes[s], "tostring", best[2], written, nodes, allocs[2]);
+			if (lookup_count)
+				report(name, sizes[s], "get_member", best[3], 0, lookup_count, allocs[3]);
+			report(name, sizes[s], "destroy", best[4], buf.length, nodes, allocs[4]);
+
+			free(lookups);
+			json_destroy(root);
+			free(buf.data);
+		}
+	}
+}
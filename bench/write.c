@@ -0,0 +1,60 @@
+#define LIBJSON_IMPLEMENTATION
+#include "libjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Measures serialization throughput of a document made of many copies of tests/grid.json
+
+#define COPIES 20000
+#define ROUNDS 10
+
+double seconds(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+void bench(JSON* root, int format)
+{
+	const char* name = format ? "formatted" : "compact";
+
+	size_t bytes = 0;
+	clock_t start = clock();
+	for (int round = 0; round < ROUNDS; round++)
+	{
+		char* str = json_tostring(root, format);
+		bytes += strlen(str);
+		free(str);
+	}
+	double elapsed = seconds(start);
+	printf("json_tostring %-10s %8.1f MB/s\n", name, bytes / elapsed / 1e6);
+
+	char* buf = NULL;
+	size_t size = 0;
+	bytes = 0;
+	start = clock();
+	for (int round = 0; round < ROUNDS; round++)
+		bytes += json_tobuffer(root, format, &buf, &size);
+	elapsed = seconds(start);
+	printf("json_tobuffer %-10s %8.1f MB/s\n", name, bytes / elapsed / 1e6);
+	free(buf);
+}
+
+int main()
+{
+	JSON* grid = json_loadfile("./tests/grid.json");
+	if (grid == NULL)
+		return 1;
+	char* str = json_tostring(grid, JSON_COMPACT);
+
+	JSON* root = json_create_array();
+	for (int i = 0; i < COPIES; i++)
+		json_add_element(root, json_loadstring(str));
+	free(str);
+
+	bench(root, JSON_COMPACT);
+	bench(root, JSON_FORMAT);
+
+	json_destroy(root);
+	json_destroy(grid);
+}
@@ -19,6 +19,15 @@
 //
 // JSON_MALLOC, JSON_REALLOC, and JSON_FREE to use your own allocators instead of the standard library
 // JSON_MESSAGE (default fputs(m, stderr)) to set your own message callback.
+// JSON_INDEX_THRESHOLD (default 8) the number of members at which an object gets a hash index of its member names
+// JSON_WRITE_BUFFER (default 65536) the size of the buffer json_write_to and json_writefile write through
+// JSON_BATCH_CHUNK (default 1048576) the bytes of input the threads of json_batch_loadbuffer take at a time, and the
+// least json_loadbuffer_parallel gives each thread
+// JSON_NO_SIMD to scan with plain C instead of SSE2 and AVX2 on x86-64
+// JSON_VALIDATE_UTF8 to reject strings that aren't valid UTF-8 while parsing
+// JSON_MAX_DEPTH (default 10000) how deeply objects and arrays can be nested in parsed json
+// JSON_INTERN_LIMIT (default 4096) the number of distinct member names a document or batch shares
+// JSON_STATS to count allocations and the time spent parsing and writing, read with json_stats_get
 //
 // ## Types
 // The library represents all json types with the JSON structure
@@ -39,19 +48,26 @@
 // Arrays are an ordered collection of values
 //
 // In libjson they are both represented as children of a JSON structure with type JSON_TOBJECT or JSON_TARRAY
-// Each child is a JSON struct on it's own and contains the name and the value of the pair. This means that the members
-// can be looked at independently from the parent object since they store their own name
+// Each child is a JSON struct on it's own and contains the value of the pair. The names are stored once in the object
+// and json_get_name(member) finds it through the member's parent. A member popped from its object keeps its name
 //
-// The children are stored in a double linked list. The difference between object members and array elements is that the
-// name is NULL
+// The children are stored contiguously in their object or array. The elements of an array are retrieved by index with
+// json_get_element(array, index) in constant time. The difference between object members and array elements is that
+// the name is NULL
 //
-// To retrieve a member of a certain name, use json_get_member(object), this iterates the linked list until a match is
-// found, and returns NULL if no match is found at end
+// To retrieve a member of a certain name, use json_get_member(object), this iterates the members until a match is
+// found, and returns NULL if no match is found at end. Objects with JSON_INDEX_THRESHOLD (default 8) or more members
+// keep a hash index of their member names so that looking up, adding, and popping members doesn't scan the list
+//
+// Trees built with json_add_member copy every name. json_keys_create makes a table of shared names, where
+// json_keys_intern returns the same copy for equal names, and json_add_member_shared adds a member without copying its
+// name. Records built with shared names don't repeat them, and json_get_member finds a shared name by its pointer
+// before comparing strings. The table must outlive all members added with its names
 //
 // If you want to loop through the members or elements of a object or array, use json_get_members, or json_get_elements
 // respectively
 //
-// This will return the first JSON struct in the linked list, the next item can be retrieved with json_get_next(member)
+// This will return the first member or element, the next item can be retrieved with json_get_next(member)
 //
 // Example:
 // ```
@@ -76,12 +92,187 @@
 // json_set_string or similar call. You can write to the string but not realloc it. Long term storage of the return
 // value is not recommended
 //
+// Strings are UTF-8. Escape sequences \uXXXX are decoded when parsing, with surrogate pairs combined into one character
+// and lone surrogates rejected. Other bytes are kept as they are, unless JSON_VALIDATE_UTF8 is defined, in which case
+// strings that aren't valid UTF-8 make the json invalid. Runs of ASCII are validated 16 characters at a time.
+//
 // ### Numbers and Bools
-// Numbers represent a double precision floating point value. Bools are also a type of number with either the value 1 or
-// 0
+// Scalars are stored directly in their 24 byte JSON struct. Numbers represent a double precision floating point value.
+// Bools are also a type of number with either the value 1 or 0
+//
+// Numbers are parsed to the nearest double, correctly rounded. Integers without a fraction or exponent that fit in 64
+// bits are kept exactly and can be read with json_get_integer, or created with json_create_integer. json_get_integer
+// truncates other numbers toward zero, saturating at INT64_MIN and INT64_MAX, and reads NaN as 0
+//
+// Numbers are written with the fewest digits that read back as the same double. Integral values are written without
+// fraction or exponent. Infinity and NaN can't be represented in json and are written as null
 //
 // ### Null
 // Null is a valid json type and has no other use than indicate the absence of a value
+//
+// ### Documents
+// Loading with json_loadstring or json_loadfile allocates every node, name and string separately, which is what you
+// want when the tree is modified afterwards.
+//
+// For trees that are only read, json_doc_loadstring and json_doc_loadfile load into a document instead. All nodes,
+// names and strings of a document are bump allocated from a few large blocks owned by the document, and
+// json_doc_destroy frees them all at once without walking the tree.
+//
+// The root of the document is retrieved with json_doc_root and can be read with all the usual getters. Nodes of a
+// document must not be modified, popped, or destroyed individually.
+//
+// json_doc_loadstring_insitu doesn't copy strings at all. Strings and names are unescaped in place in the loaded
+// string and point into it, so the string is modified and must outlive the document. json_doc_loadfile does the same
+// with the file contents, which are freed together with the document.
+//
+// Documents and json_batch_loadbuffer share the names of members. Every distinct name is copied once, also when loading
+// in situ, and members with equal names point to the same copy, so records repeating the same names only store them
+// once. json_doc_key(doc, name) returns the copy, and looking up members with it compares pointers instead of strings.
+// Names that are mostly distinct, like those of an object used as a map, and names past the first JSON_INTERN_LIMIT
+// (default 4096) distinct ones are stored for each member as before.
+//
+// Objects whose members have the same names in the same order as the previous object at the same depth, like the
+// records of an array, also share their shape. Only their members are stored, while the names and the hash index of the
+// names are kept once for all objects of the shape. json_get_member_cached(object, name, &slot) looks up a member like
+// json_get_member but tries the slot it was last found in first, so a loop over records of the same shape finds the
+// member without searching.
+//
+// With JSON_USE_POSIX, json_loadfile and json_doc_loadfile map the file with mmap instead of reading it into a copy.
+// The parser is bounded by the length of the input rather than a terminating zero, and the document maps the file
+// privately so only the pages with strings in them are copied when unescaped in place.
+//
+// json_loadbuffer and json_doc_loadbuffer load len bytes from a buffer that doesn't need to be zero terminated.
+//
+// Example:
+// ```
+// JSONDoc* doc = json_doc_loadfile("example.json");
+// printf("name is %s\n", json_get_member_string(json_doc_root(doc), "name"));
+// json_doc_destroy(doc);
+// ```
+//
+// ### Events
+// json_parse reads json without building a tree. Every value is passed in order to the callbacks of a JSONHandler,
+// such as start_object, key, string, number, and end_array, and any callback can be NULL to skip the event. Memory
+// use only depends on the nesting depth, so arbitrarily large documents can be processed. The tree loaders are built
+// on the same parser. Nothing recurses, and json nested deeper than JSON_MAX_DEPTH is rejected as invalid so that
+// untrusted input can't use up memory with brackets alone. Trees of any depth can still be written and destroyed.
+//
+// Example:
+// ```
+// int on_number(void* ctx, double num)
+// {
+// 	*(double*)ctx += num;
+// 	return 0;
+// }
+//
+// double sum = 0;
+// JSONHandler handler = {.number = on_number};
+// json_parse(str, strlen(str), &handler, &sum);
+// ```
+//
+// json_parser_create makes a push parser for json that arrives in pieces, such as a message read from a socket. Each
+// chunk is passed to json_parser_feed as it is received and its events are passed on right away, so parsing overlaps
+// receiving instead of waiting for the whole message. Chunks can end anywhere, even inside a string, escape sequence,
+// or number, and don't need to be kept after the call. json_parser_finish ends the input. With a NULL handler the
+// parser builds a tree, which is taken with json_parser_root.
+//
+// Example:
+// ```
+// JSONParser* parser = json_parser_create(NULL, NULL);
+// while ((len = recv(sock, buf, sizeof buf, 0)) > 0)
+// 	json_parser_feed(parser, buf, len);
+// if (json_parser_finish(parser) == 0)
+// 	root = json_parser_root(parser);
+// json_parser_destroy(parser);
+// ```
+//
+// ### Errors
+// json_loadstring, json_loadfile, json_doc_loadstring, json_parse and the other loaders pass a message saying why and
+// where json is invalid to JSON_MESSAGE, such as "String contains invalid json data at line 3, column 8: Expected ':'
+// after member name". The message is only formatted once the whole load failed.
+//
+// json_loadbuffer_error, json_doc_loadbuffer_error, json_loadbuffer_parallel_error and json_parse_error set a JSONError
+// instead, with one of the JSON_ERROR codes and the byte offset, line, and column of the character parsing failed at.
+// No message is formatted and lines are only counted after failing, so rejecting invalid json costs little more than
+// reading up to the error. Parsing always stops at the first error. json_error_string describes a code.
+//
+// json_parser_error gives the error of a push parser, with the offset into all chunks fed, and json_lines_error the
+// error of the last invalid line, with its line number. Both leave the messages out, since invalid records are expected
+// in a stream.
+//
+// Example:
+// ```
+// JSONError error;
+// JSON* root = json_loadbuffer_error(buf, len, &error);
+// if (root == NULL)
+// 	printf("%s at %zu:%zu\n", json_error_string(error.code), error.line, error.column);
+// ```
+//
+// ### Writing
+// json_tostring returns the whole document as an allocated string. json_tobuffer writes into a buffer owned by the
+// caller, which can be reused between calls so that it isn't reallocated.
+//
+// json_write_to writes the document in chunks to a JSONWriteFn callback, so only a buffer of JSON_WRITE_BUFFER
+// (default 65536) bytes is held in memory instead of the whole string. json_sink_file writes to a FILE*, and
+// json_sink_fd to a file descriptor with JSON_USE_POSIX. json_writefile uses json_write_to.
+//
+// Combining the format with JSON_ASCII, as in JSON_FORMAT | JSON_ASCII, writes every character outside ASCII as \uXXXX
+// or a surrogate pair, and invalid UTF-8 as \ufffd.
+//
+// Example:
+// ```
+// json_write_to(root, json_sink_file, stdout, JSON_FORMAT);
+// ```
+//
+// ### Newline delimited json
+// json_lines_openfile and json_lines_openbuffer read newline delimited json (NDJSON), where every line holds one
+// record. json_lines_next loads the next record without copying or terminating the line, and blank lines are skipped. A
+// record is only valid until the next call, since the memory and parser state of each record are reused for the next
+// one. An invalid line returns -1 and reading can continue after it.
+//
+// json_lines_write writes a record as compact json and a newline through a JSONWriteFn. All records share the buffer of
+// a JSONLinesWriter instead of allocating a string each.
+//
+// Example:
+// ```
+// JSONLines* lines = json_lines_openfile("log.ndjson");
+// JSONLinesWriter* writer = json_lines_writer_create(json_sink_file, stdout);
+// JSON* record;
+// while (json_lines_next(lines, &record) > 0)
+// 	if (json_get_member_bool(record, "error"))
+// 		json_lines_write(writer, record);
+// json_lines_writer_close(writer);
+// json_lines_close(lines);
+// ```
+//
+// json_batch_loadfile and json_batch_loadbuffer load all records at once on several threads. The input is split into
+// chunks on line boundaries, which the threads take in turn and load into arenas of their own. json_batch_get returns
+// the records in input order, and NULL for invalid lines. Threads need JSON_USE_POSIX, where pthread has to be linked,
+// or JSON_USE_WINAPI.
+//
+// ### Parallel loading
+// json_loadbuffer_parallel and json_loadfile_parallel load a single large array or object on several threads. The
+// threads first scan parts of the string to find where strings start and end and how deep every bracket is, so that the
+// members or elements can be split into one range per thread. The scans classify 64 characters at a time into masks of
+// quotes, backslashes, brackets and commas, with SSE2, or AVX2 when the processor supports it, and follow strings from
+// one block to the next with bit operations. Without SSE2 they skip strings with memchr instead. The ranges are then
+// parsed at the same time and gathered into the root. Each thread gets at least JSON_BATCH_CHUNK bytes, and smaller
+// strings as well as other values are loaded like json_loadbuffer. Errors are reported like those of json_loadbuffer,
+// with the offset, line, and column of the first error in the whole string.
+//
+// ### Columns
+// json_extract_numbers, json_extract_strings, and json_extract_bools write one member of every element of an array into
+// an array of doubles, strings, or ints, such as the balance of every record. The elements are walked once, and the
+// member is looked up in the slot it was found in before, or directly for objects of the same shape. Elements without
+// the member get the same value json_get_member_number, json_get_member_string, and json_get_member_bool return for
+// them. json_extract_parallel does the same for a type on several threads, with at least 16384 elements each.
+//
+// ### Statistics
+// Built with JSON_STATS, the library counts the allocations and bytes of nodes, children, member names, strings,
+// arenas, writer buffers and parser buffers, how often the writer and parser scratch buffers grew, and the runs, bytes
+// and nanoseconds of parsing and writing. json_stats_get returns the counts since the start or the last
+// json_stats_reset. The counts are added atomically, so they cover all threads. Without JSON_STATS the counting
+// compiles to nothing.
 
 // LICENSE
 // See the end of the file for license
@@ -90,11 +281,26 @@
 #ifndef LIBJSON_H
 #define LIBJSON_H
 #include <stddef.h>
+#include <stdint.h>
 
 typedef struct JSON JSON;
+typedef struct JSONDoc JSONDoc;
+typedef struct JSONHandler JSONHandler;
+typedef struct JSONParser JSONParser;
+typedef struct JSONLines JSONLines;
+typedef struct JSONLinesWriter JSONLinesWriter;
+typedef struct JSONBatch JSONBatch;
+typedef struct JSONError JSONError;
+typedef struct JSONKeys JSONKeys;
+
+// Receives len bytes of serialized json from json_write_to
+// Returns 0 on success, anything else stops the writing
+typedef int (*JSONWriteFn)(void* ctx, const char* data, size_t len);
 
 #define JSON_COMPACT 0
 #define JSON_FORMAT	 1
+// Combined with JSON_COMPACT or JSON_FORMAT to write every character outside ASCII as an escape sequence
+#define JSON_ASCII 2
 
 #define JSON_TINVALID 0
 #define JSON_TOBJECT  1
@@ -104,6 +310,50 @@ typedef struct JSON JSON;
 #define JSON_TBOOL	  16
 #define JSON_TNULL	  32
 
+// Why loading or parsing failed, see JSONError
+#define JSON_ERROR_NONE		0
+// Memory couldn't be allocated
+#define JSON_ERROR_MEMORY	1
+// The input ended before the value did, or holds no value at all
+#define JSON_ERROR_END		2
+// A character that can't start a value
+#define JSON_ERROR_VALUE	3
+// A member name was expected
+#define JSON_ERROR_NAME		4
+// The colon after a member name was expected
+#define JSON_ERROR_COLON	5
+// A comma or the end of the object or array was expected
+#define JSON_ERROR_COMMA	6
+// A number is missing digits
+#define JSON_ERROR_NUMBER	7
+// An invalid escape sequence or a lone surrogate
+#define JSON_ERROR_ESCAPE	8
+// A control character in a string that isn't escaped
+#define JSON_ERROR_CONTROL	9
+// A string that isn't valid UTF-8, with JSON_VALIDATE_UTF8
+#define JSON_ERROR_UTF8		10
+// Objects and arrays nested deeper than JSON_MAX_DEPTH
+#define JSON_ERROR_DEPTH	11
+// Something other than whitespace follows the value
+#define JSON_ERROR_TRAILING 12
+// A callback of the JSONHandler stopped parsing
+#define JSON_ERROR_STOPPED	13
+
+// Where and why json is invalid
+struct JSONError
+{
+	// One of the JSON_ERROR codes
+	int code;
+	// The byte offset of the character parsing failed at, counted from the start of the input
+	size_t offset;
+	// The line and the byte in the line of that character, both starting at 1
+	size_t line;
+	size_t column;
+};
+
+// Returns a short description of one of the JSON_ERROR codes
+const char* json_error_string(int code);
+
 // Creates an empty json with invalid type
 JSON* json_create_empty();
 // Creates a valid json null
@@ -116,6 +366,9 @@ JSON* json_create_string(const char* str);
 // Creates a json number
 JSON* json_create_number(double value);
 
+// Creates a json number that stores value exactly instead of as a double
+JSON* json_create_integer(int64_t value);
+
 // Creates an empty json object with no members
 JSON* json_create_object();
 
@@ -133,6 +386,10 @@ void json_set_string(JSON* object, const char* str);
 // Previous value is freed
 void json_set_number(JSON* object, double num);
 
+// Sets the value of the json object to a number stored exactly as an integer
+// Previous value is freed
+void json_set_integer(JSON* object, int64_t num);
+
 // Sets the value of the json object to a bool
 // Previous value is freed
 void json_set_bool(JSON* object, int val);
@@ -160,6 +417,12 @@ char* json_get_string(JSON* object);
 // Returns 0 if it's not a number type
 double json_get_number(JSON* object);
 
+// Returns the number value as an integer
+// Integers without fraction or exponent are loaded exactly if they fit in 64 bits, other numbers are truncated
+// toward zero. Numbers beyond the range of int64_t saturate to INT64_MIN or INT64_MAX, and NaN is 0
+// Returns 0 if it's not a number type
+int64_t json_get_integer(JSON* object);
+
 // Returns the bool value
 // Returns 0 if it's not a bool type
 int json_get_bool(JSON* object);
@@ -170,6 +433,9 @@ char* json_get_member_string(JSON* object, const char* name);
 // Gets a member of an object and returns its number value
 double json_get_member_number(JSON* object, const char* name);
 
+// Gets a member of an object and returns its integer value
+int64_t json_get_member_integer(JSON* object, const char* name);
+
 // Gets a member of an object and returns its bool value
 int json_get_member_bool(JSON* object, const char* name);
 
@@ -179,9 +445,36 @@ JSON* json_get_members(JSON* object);
 // Returns the member with the specified name in a json object
 JSON* json_get_member(JSON* object, const char* name);
 
-// Returns a linked list of the elements of a json array
+// Returns the member with the specified name like json_get_member, trying the slot it was last found in first
+// slot starts out as -1 and is kept across calls, so looking up the same name in objects of the same shape, such as
+// the records of an array, finds the member without searching
+JSON* json_get_member_cached(JSON* object, const char* name, int* slot);
+
+// Writes the number value of the member name of each element of an array to out, at most n values
+// Elements without the member get 0 like json_get_member_number
+// Returns the number of values written, which is the number of elements if n is large enough
+size_t json_extract_numbers(JSON* array, const char* name, double* out, size_t n);
+
+// Writes the string value of the member name of each element of an array to out, at most n values
+// The strings point into the tree, elements without a string member get NULL like json_get_member_string
+size_t json_extract_strings(JSON* array, const char* name, char** out, size_t n);
+
+// Writes the bool value of the member name of each element of an array to out, at most n values
+size_t json_extract_bools(JSON* array, const char* name, int* out, size_t n);
+
+// Extracts like json_extract_numbers, json_extract_strings, or json_extract_bools for type JSON_TNUMBER, JSON_TSTRING,
+// or JSON_TBOOL respectively, with the elements split between threads threads, or one per processor if 0
+// Threads are only used with JSON_USE_POSIX or JSON_USE_WINAPI and for large arrays
+size_t json_extract_parallel(JSON* array, const char* name, int type, void* out, size_t n, int threads);
+
+// Returns the first element of a json array
+// The following elements can be retrieved with json_get_next
 JSON* json_get_elements(JSON* object);
 
+// Returns the element at index in a json array
+// Returns NULL if index is out of range or object is not an array
+JSON* json_get_element(JSON* object, int index);
+
 // Gets the number of members of an object or array
 int json_get_count(JSON* object);
 
@@ -193,28 +486,230 @@ JSON* json_get_next(JSON* element);
 // Returned string needs to be manually freed
 // If format is 0, resulting string will not contain whitespace
 // If format is 1, resulting string will be pretty formatted
+// JSON_ASCII can be added to either to escape every character outside ASCII
+// Returns NULL if memory couldn't be allocated
 char* json_tostring(JSON* object, int format);
 
+// Writes a json structure as a string into *buf, which has *size bytes allocated with JSON_MALLOC
+// *buf is grown with JSON_REALLOC when needed, and may be NULL to allocate a new buffer
+// Passing the same buffer for every call avoids reallocating it once it is large enough
+// The buffer needs to be manually freed
+// Returns the length of the string, or 0 if memory couldn't be allocated
+size_t json_tobuffer(JSON* object, int format, char** buf, size_t* size);
+
+// Writes a json structure through write in chunks of at most JSON_WRITE_BUFFER bytes
+// Only the buffer is held in memory, unless a single string is larger
+// Returns 0 on success, or -1 if write failed or memory couldn't be allocated
+int json_write_to(JSON* object, JSONWriteFn write, void* ctx, int format);
+
+// JSONWriteFn that writes to the FILE* ctx
+int json_sink_file(void* ctx, const char* data, size_t len);
+
+#if JSON_USE_POSIX
+// JSONWriteFn that writes to the file descriptor ctx, cast with (void*)(intptr_t)fd
+int json_sink_fd(void* ctx, const char* data, size_t len);
+#endif
+
 // Writes the json structure to a file
 // Not that the name of the root object, if not NULL, is the file that was read
-// Returns 0 on success
+// The file is written in chunks with json_write_to, without building the whole string first
+// Returns 0 on success, -1 if a directory couldn't be created, -2 if the file couldn't be opened, and -3 if writing
+// failed
 // Overwrites file
 // Creates the directories leading up to it (JSON_USE_POSIX or JSON_USE_WINAPI need to be defined accordingly)
-// If format is JSON_COMPACT (1), resulting string will not contain whitespace
-// If format is JSON_FORMAT (0), resulting string will be pretty formatted
+// If format is JSON_COMPACT (0), resulting string will not contain whitespace
+// If format is JSON_FORMAT (1), resulting string will be pretty formatted
 int json_writefile(JSON* object, const char* filepath, int format);
 
 // Loads a json file recusively from a file into memory
+// With JSON_USE_POSIX the file is mapped and parsed directly instead of being read into a copy
 JSON* json_loadfile(const char* filepath);
 
 // Loads a json string recursively
 JSON* json_loadstring(char* str);
 
+// Loads len bytes of json from buf, which doesn't need to be zero terminated
+JSON* json_loadbuffer(const char* buf, size_t len);
+
+// Loads len bytes of json from buf like json_loadbuffer
+// If the json is invalid, NULL is returned and error is set to why and where, without formatting a message
+JSON* json_loadbuffer_error(const char* buf, size_t len, JSONError* error);
+
 // Loads a json object from a string
 // Returns a pointer to the end of the object in the beginning string
 // NOTE : should not be used on an existing object, object needs to be empty or destroyed
 char* json_load(JSON* object, char* str);
 
+// Callbacks for the events of json_parse, any of which can be NULL to ignore the event
+// Return 0 to continue parsing, anything else stops it
+// Strings and names are passed unescaped with their length, they are not zero terminated and are only valid during the
+// call
+struct JSONHandler
+{
+	int (*start_object)(void* ctx);
+	int (*end_object)(void* ctx);
+	int (*start_array)(void* ctx);
+	int (*end_array)(void* ctx);
+	// The name of the member whose value follows
+	int (*key)(void* ctx, const char* name, size_t len);
+	int (*string)(void* ctx, const char* str, size_t len);
+	int (*number)(void* ctx, double num);
+	// Integers without fraction or exponent that fit in 64 bits, passed to number instead if NULL
+	int (*integer)(void* ctx, int64_t num);
+	int (*boolean)(void* ctx, int val);
+	int (*null)(void* ctx);
+};
+
+// Parses len bytes of json from buf and passes every value to handler in order, without building a tree
+// Memory use depends on the nesting depth and the longest string with escape sequences, not on the size of buf
+// Only whitespace may follow the value
+// Returns 0 on success, -1 if the json is invalid, and -2 if a callback stopped parsing
+int json_parse(const char* buf, size_t len, const JSONHandler* handler, void* ctx);
+
+// Parses len bytes of json from buf like json_parse
+// If parsing fails, error is set to why and where, without formatting a message
+int json_parse_error(const char* buf, size_t len, const JSONHandler* handler, void* ctx, JSONError* error);
+
+// Creates a parser that is given the json in chunks of any size with json_parser_feed, such as the pieces of a message
+// as they are received. Events are passed to handler as soon as the chunk completing them is fed
+// If handler is NULL, a tree is built instead and returned by json_parser_root
+// Returns NULL if memory couldn't be allocated
+JSONParser* json_parser_create(const JSONHandler* handler, void* ctx);
+
+// Parses the next len bytes of json from buf
+// Chunks may end anywhere, including inside a string, escape sequence, or number. The part of a value that is cut off
+// is copied and completed by the next chunk, so buf doesn't need to outlive the call
+// Returns 0 on success, -1 if the json is invalid, and -2 if a callback stopped parsing
+// Once it fails, the parser stays failed
+int json_parser_feed(JSONParser* parser, const char* buf, size_t len);
+
+// Ends the input, completing a number at the very end
+// Returns 0 if a whole json value was fed, -1 if it is invalid or incomplete, and -2 if a callback stopped parsing
+int json_parser_finish(JSONParser* parser);
+
+// Returns the tree built by a parser created without handler after json_parser_finish succeeded, otherwise NULL
+// The tree is handed over to the caller and needs to be destroyed with json_destroy
+JSON* json_parser_root(JSONParser* parser);
+
+// Sets error to why and where the parser failed
+// The offset counts the bytes of all chunks fed. Line and column are 0, since earlier chunks aren't kept
+void json_parser_error(JSONParser* parser, JSONError* error);
+
+// Frees the parser, and the tree it built unless it was taken with json_parser_root
+void json_parser_destroy(JSONParser* parser);
+
+// Loads a json string into a document
+// All nodes, names, and strings are allocated in blocks owned by the document
+// Returns NULL if the string contains none or invalid json data
+JSONDoc* json_doc_loadstring(char* str);
+
+// Loads len bytes of json from buf into a document, buf doesn't need to be zero terminated
+JSONDoc* json_doc_loadbuffer(const char* buf, size_t len);
+
+// Loads len bytes of json from buf into a document like json_doc_loadbuffer
+// If the json is invalid, NULL is returned and error is set to why and where, without formatting a message
+JSONDoc* json_doc_loadbuffer_error(const char* buf, size_t len, JSONError* error);
+
+// Loads a json string into a document without copying its strings
+// Strings and names are unescaped in place and point into str, which is modified
+// str must stay valid and unmodified until the document is destroyed
+// Returns NULL if the string contains none or invalid json data
+JSONDoc* json_doc_loadstring_insitu(char* str);
+
+// Loads a json file into a document
+// The file contents are kept by the document and its strings point into them
+// With JSON_USE_POSIX the file is mapped instead of read, and only pages with strings in them are copied
+// Returns NULL if the file couldn't be read or contains none or invalid json data
+JSONDoc* json_doc_loadfile(const char* filepath);
+
+// Returns the root json object of a document
+// The tree is owned by the document and must not be modified or destroyed
+JSON* json_doc_root(JSONDoc* doc);
+
+// Returns the copy of name shared by the members of the document, or name itself if the document doesn't share it
+// Looking up members with the shared copy compares pointers instead of strings
+const char* json_doc_key(JSONDoc* doc, const char* name);
+
+// Frees a document and all its nodes, names, and strings at once
+void json_doc_destroy(JSONDoc* doc);
+
+// Opens newline delimited json (NDJSON) from a buffer of len bytes, where every line holds one record
+// The buffer is read in place and needs to outlive the reader
+// Returns NULL if memory couldn't be allocated
+JSONLines* json_lines_openbuffer(const char* buf, size_t len);
+
+// Opens a file of newline delimited json, mapped with JSON_USE_POSIX
+// Returns NULL if the file couldn't be opened
+JSONLines* json_lines_openfile(const char* filepath);
+
+// Loads the next record into *record, skipping blank lines
+// The record is owned by the reader and is only valid until the next call, its memory is reused for the next record
+// Returns 1 if a record was read, 0 at the end, and -1 if the line is invalid, in which case reading can continue with
+// the next line
+int json_lines_next(JSONLines* lines, JSON** record);
+
+// Returns the line number of the last record read, starting at 1
+size_t json_lines_line(JSONLines* lines);
+
+// Sets error to why and where the last line read is invalid, after json_lines_next returned -1
+// The offset counts from the start of the buffer or file
+void json_lines_error(JSONLines* lines, JSONError* error);
+
+// Frees the reader and the last record
+void json_lines_close(JSONLines* lines);
+
+// Creates a writer of newline delimited json that writes through write
+// Records are collected in a buffer of JSON_WRITE_BUFFER bytes that is shared by all records
+// Returns NULL if memory couldn't be allocated
+JSONLinesWriter* json_lines_writer_create(JSONWriteFn write, void* ctx);
+
+// Writes a record as compact json followed by a newline
+// Returns 0 on success, or -1 if writing failed or memory couldn't be allocated
+int json_lines_write(JSONLinesWriter* writer, JSON* record);
+
+// Writes what is left in the buffer and frees the writer
+// Returns 0 if all records were written, otherwise -1
+int json_lines_writer_close(JSONLinesWriter* writer);
+
+// Loads every record of newline delimited json from a buffer of len bytes on several threads
+// The input is split into chunks of about JSON_BATCH_CHUNK bytes on line boundaries, which the threads take in turn and
+// load into arenas of their own. threads includes the calling thread, and 0 uses one per processor
+// Threads are only used with JSON_USE_POSIX or JSON_USE_WINAPI, otherwise all records are loaded on the calling thread
+// The records are owned by the batch and can be read until it is destroyed, the buffer needs to outlive the batch
+// Returns NULL if memory couldn't be allocated
+JSONBatch* json_batch_loadbuffer(const char* buf, size_t len, int threads);
+
+// Loads every record of a file of newline delimited json on several threads, see json_batch_loadbuffer
+// Returns NULL if the file couldn't be opened
+JSONBatch* json_batch_loadfile(const char* filepath, int threads);
+
+// Returns the number of records in the batch, counting invalid lines but not blank ones
+size_t json_batch_count(JSONBatch* batch);
+
+// Returns the record at index in input order
+// Returns NULL if the line of the record is invalid or index is out of range
+JSON* json_batch_get(JSONBatch* batch, size_t index);
+
+// Frees the batch and all of its records
+void json_batch_destroy(JSONBatch* batch);
+
+// Loads a json string of len bytes whose outermost value is a large array or object on several threads
+// The strings and brackets of the whole string are found first, with each thread scanning a part. The members or
+// elements are then split into as many ranges, which are parsed on their own threads and gathered into the root
+// threads includes the calling thread, and 0 uses one per processor. Every thread gets at least JSON_BATCH_CHUNK bytes,
+// so smaller strings are split between fewer threads. Strings of less than two chunks and other values are loaded like
+// json_loadbuffer
+JSON* json_loadbuffer_parallel(const char* buf, size_t len, int threads);
+
+// Loads a json string of len bytes on several threads like json_loadbuffer_parallel
+// If the string is invalid, error is set to why and where it first is, with the offset, line, and column in the whole
+// string
+// Returns NULL if the string is invalid or memory couldn't be allocated
+JSON* json_loadbuffer_parallel_error(const char* buf, size_t len, int threads, JSONError* error);
+
+// Loads a json file on several threads, see json_loadbuffer_parallel
+JSON* json_loadfile_parallel(const char* filepath, int threads);
+
 // Destroys a member from the json structure
 void json_destroy_member(JSON* object, const char* name);
 
@@ -235,12 +730,25 @@ JSON* json_pop_element(JSON* object, int pos);
 // If an object of that name already exists, it is overwritten
 void json_add_member(JSON* object, const char* name, JSON* value);
 
+// Insert a member to a json object like json_add_member, but without copying name
+// name is shared and must stay valid as long as the member, such as a literal or a name from json_keys_intern
+void json_add_member_shared(JSON* object, const char* name, JSON* value);
+
+// Creates an empty table of shared member names
+JSONKeys* json_keys_create();
+
+// Returns the copy of name in the table, which is made the first time name is interned
+// Equal names return the same pointer, which stays valid until the table is destroyed
+const char* json_keys_intern(JSONKeys* keys, const char* name);
+
+// Frees the table and all of its names, no member added with them may still exist
+void json_keys_destroy(JSONKeys* keys);
+
 // Insert an element into arbitrary position in a json array
-// If index is greater than the length of the array, element will be inserted at the end
-// if element is a linked list, the whole list will be inserted in order
+// If index is negative or greater than the length of the array, element will be inserted at the end
 void json_insert_element(JSON* object, int pos, JSON* element);
 
-// Insert an element to the beginning of a json array
+// Insert an element to the end of a json array
 void json_add_element(JSON* object, JSON* element);
 
 // Recursively destroys and frees an object
@@ -248,6 +756,54 @@ void json_add_element(JSON* object, JSON* element);
 // Element should be remove from parent before calling destroy
 void json_destroy(JSON* object);
 
+#ifdef JSON_STATS
+// The allocations of one kind of memory and the bytes they requested
+struct JSONStatsCount
+{
+	uint64_t allocs;
+	uint64_t bytes;
+};
+
+// What the library allocated and how long it spent parsing and writing, counted with JSON_STATS
+// Allocations from the arenas of documents count the same as those made with JSON_MALLOC, and reallocations count as
+// allocations of the new size
+struct JSONStats
+{
+	struct JSONStatsCount nodes;
+	// Children of objects and arrays, and the hash indices of their names
+	struct JSONStatsCount children;
+	struct JSONStatsCount names;
+	struct JSONStatsCount strings;
+	// Blocks allocated by documents, readers, and batches to hold their nodes, names, and strings
+	struct JSONStatsCount arenas;
+	// The buffers json is written to
+	struct JSONStatsCount writer;
+	// The parser's scratch buffer for strings with escape sequences, its stack, the tokens the push parser carries
+	// over, and the lists the loader collects children in
+	struct JSONStatsCount parser;
+	// Times the writer's buffer and the parser's scratch buffer were grown
+	uint64_t writer_grows;
+	uint64_t scratch_grows;
+	// Runs of the parser, one for each document, record, chunk fed, or range loaded in parallel, with the bytes they
+	// parsed and the nanoseconds they took, including building the tree
+	uint64_t parses;
+	uint64_t parse_bytes;
+	uint64_t parse_ns;
+	// Values written, with the bytes written and the nanoseconds it took
+	uint64_t writes;
+	uint64_t write_bytes;
+	uint64_t write_ns;
+};
+typedef struct JSONStats JSONStats;
+
+// Returns the counts since the program started or json_stats_reset was called
+// The counts are shared by all threads, which add to them atomically
+JSONStats json_stats_get();
+
+// Sets all counts to zero
+void json_stats_reset();
+#endif
+
 // End of header
 // Implementation
 #ifdef LIBJSON_IMPLEMENTATION
@@ -256,6 +812,7 @@ void json_destroy(JSON* object);
 #include <string.h>
 #include <math.h>
 #include <limits.h>
+#include <locale.h>
 
 #ifndef JSON_MALLOC
 #define JSON_MALLOC(s) malloc(s)
@@ -266,10 +823,39 @@ void json_destroy(JSON* object);
 #ifndef JSON_REALLOC
 #define JSON_REALLOC(p, s) realloc(p, s)
 #endif
+#ifndef JSON_WRITE_BUFFER
+#define JSON_WRITE_BUFFER 65536
+#endif
+#ifndef JSON_BATCH_CHUNK
+#define JSON_BATCH_CHUNK 1048576
+#endif
+#ifndef JSON_MAX_DEPTH
+#define JSON_MAX_DEPTH 10000
+#endif
+#ifndef JSON_INTERN_LIMIT
+#define JSON_INTERN_LIMIT 4096
+#endif
+
+// Blocks of 64 characters are classified 16 at a time with SSE2, or 32 with AVX2 if the processor supports it
+#if !defined(JSON_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64))
+#define JSON_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define JSON_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
 
 #if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
 #include <sys/stat.h>
 #endif
+#if JSON_USE_POSIX
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 #if defined(_WIN32) || defined(WIN32)
 #include <windows.h>
 #endif
@@ -280,6 +866,68 @@ void json_destroy(JSON* object);
 #define JSON_MESSAGE(m) fputs(m, stderr)
 #endif
 
+#ifdef JSON_STATS
+#include <time.h>
+
+static JSONStats json_stats;
+
+#if defined(__GNUC__) || defined(__clang__)
+#define JSON_STATS_ADD(field, n)   __atomic_fetch_add(&json_stats.field, (uint64_t)(n), __ATOMIC_RELAXED)
+#define JSON_STATS_LOAD(count)	   __atomic_load_n(&(count), __ATOMIC_RELAXED)
+#define JSON_STATS_STORE(count, n) __atomic_store_n(&(count), (uint64_t)(n), __ATOMIC_RELAXED)
+#elif defined(_MSC_VER)
+#define JSON_STATS_ADD(field, n)   InterlockedExchangeAdd64((volatile LONG64*)&json_stats.field, (LONG64)(n))
+#define JSON_STATS_LOAD(count)	   ((uint64_t)InterlockedOr64((volatile LONG64*)&(count), 0))
+#define JSON_STATS_STORE(count, n) InterlockedExchange64((volatile LONG64*)&(count), (LONG64)(n))
+#else
+#define JSON_STATS_ADD(field, n)   (json_stats.field += (n))
+#define JSON_STATS_LOAD(count)	   (count)
+#define JSON_STATS_STORE(count, n) ((count) = (n))
+#endif
+
+// Counts an allocation of size bytes of one of the kinds of memory in JSONStats
+#define JSON_STATS_ALLOC(kind, size) (JSON_STATS_ADD(kind.allocs, 1), JSON_STATS_ADD(kind.bytes, size))
+
+// Nanoseconds from a monotonic clock where there is one
+// time.h only declares the POSIX clocks when the program asks for POSIX, otherwise processor time is measured instead
+static uint64_t json_stats_now()
+{
+#if JSON_USE_POSIX && defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#elif JSON_USE_WINAPI
+	LARGE_INTEGER count, frequency;
+	QueryPerformanceCounter(&count);
+	QueryPerformanceFrequency(&frequency);
+	return (uint64_t)(count.QuadPart * (1e9 / frequency.QuadPart));
+#else
+	return (uint64_t)(clock() * (1e9 / CLOCKS_PER_SEC));
+#endif
+}
+
+// Every count is read and reset on its own, while other threads may be adding to it
+JSONStats json_stats_get()
+{
+	JSONStats stats;
+	uint64_t* from = (uint64_t*)&json_stats;
+	uint64_t* to = (uint64_t*)&stats;
+	for (size_t i = 0; i < sizeof stats / sizeof(uint64_t); i++)
+		to[i] = JSON_STATS_LOAD(from[i]);
+	return stats;
+}
+
+void json_stats_reset()
+{
+	uint64_t* counts = (uint64_t*)&json_stats;
+	for (size_t i = 0; i < sizeof json_stats / sizeof(uint64_t); i++)
+		JSON_STATS_STORE(counts[i], 0);
+}
+#else
+#define JSON_STATS_ADD(field, n)	 ((void)0)
+#define JSON_STATS_ALLOC(kind, size) ((void)0)
+#endif
+
 // Returns a copy of str
 char* strduplicate(const char* str)
 {
@@ -290,943 +938,5079 @@ char* strduplicate(const char* str)
 	return dup;
 }
 
-struct JSONStringStream
+// The smallest block allocated by an arena
+#define JSON_ARENA_MIN_CHUNK 4096
+// All arena allocations are aligned to this
+#define JSON_ARENA_ALIGN sizeof(double)
+
+// A block of memory in an arena
+// The allocated data follows directly after the header
+struct JSONArenaChunk
 {
-	// The internal string pointer
-	char* str;
-	// The allocated size of the string
+	struct JSONArenaChunk* next;
+	// The usable size of the chunk, not including the header
 	size_t size;
-	// How much has been written to the string
-	// Does not include the null terminator
-	size_t length;
+	// How much of the chunk has been handed out
+	size_t used;
+};
+
+// A bump allocator that hands out memory from growing chunks
+// Individual allocations are never freed, the whole arena is freed at once
+struct JSONArena
+{
+	// The chunk currently allocated from, links to the previous chunks
+	struct JSONArenaChunk* head;
+	// The size of the next chunk to allocate
+	size_t next_size;
 };
 
-#define WRITE_ESCAPE(c)            \
-	escaped_str[escapedi] = '\\';  \
-	escaped_str[escapedi + 1] = c; \
-	escapedi++;
+#define JSON_ARENA_DATA(chunk) ((char*)(chunk) + sizeof(struct JSONArenaChunk))
 
-// Writes to string stream
-// If escape is 1, control characters will be escaped as two characters
-// Escaping decreases performance
-static void json_ss_write(struct JSONStringStream* ss, const char* str, int escape)
+static void json_arena_init(struct JSONArena* arena, size_t size_hint)
 {
-	if (str == NULL)
-	{
-		JSON_MESSAGE("Error writing invalid string");
-	}
+	arena->head = NULL;
+	arena->next_size = size_hint > JSON_ARENA_MIN_CHUNK ? size_hint : JSON_ARENA_MIN_CHUNK;
+}
 
-	size_t lstr = strlen(str);
-	char* escaped_str = NULL;
-	if (escape)
+static void* json_arena_alloc(struct JSONArena* arena, size_t size)
+{
+	size = (size + JSON_ARENA_ALIGN - 1) & ~(JSON_ARENA_ALIGN - 1);
+	struct JSONArenaChunk* chunk = arena->head;
+	if (chunk == NULL || chunk->used + size > chunk->size)
 	{
-		// Worst case, expect all characters to be escaped and fit \0
-		escaped_str = JSON_MALLOC(2 * lstr + 1);
+		size_t chunk_size = arena->next_size;
+		while (chunk_size < size)
+			chunk_size *= 2;
 
-		// Allocated size
-		// Look for control characters
-		size_t stri = 0, escapedi = 0;
-		for (; stri < lstr; stri++, escapedi++)
+		chunk = JSON_MALLOC(sizeof(struct JSONArenaChunk) + chunk_size);
+		if (chunk == NULL)
 		{
-			switch (str[stri])
-			{
-			case '"':
-				WRITE_ESCAPE('"');
-				break;
-			case '\b':
-				WRITE_ESCAPE('b');
-				break;
-			case '\f':
-				WRITE_ESCAPE('f');
-				break;
-			case '\n':
-				WRITE_ESCAPE('n');
-				break;
-			case '\r':
-				WRITE_ESCAPE('r');
-				break;
-			case '\t':
-				WRITE_ESCAPE('t');
-				break;
-			default:
-				escaped_str[escapedi] = str[stri];
-				break;
-			}
+			JSON_MESSAGE("Failed to allocate memory for arena");
+			return NULL;
 		}
-		lstr = escapedi;
-		escaped_str[lstr] = '\0';
+		JSON_STATS_ALLOC(arenas, sizeof(struct JSONArenaChunk) + chunk_size);
+		chunk->next = arena->head;
+		chunk->size = chunk_size;
+		chunk->used = 0;
+		arena->head = chunk;
+		// Grow geometrically so that the number of chunks stays logarithmic
+		arena->next_size = chunk_size * 2;
 	}
 
-	// Allocate first time
-	if (ss->str == NULL)
+	char* ptr = JSON_ARENA_DATA(chunk) + chunk->used;
+	chunk->used += size;
+	return ptr;
+}
+
+static void json_arena_free(struct JSONArena* arena)
+{
+	struct JSONArenaChunk* chunk = arena->head;
+	while (chunk)
 	{
-		ss->size = 8;
-		ss->str = JSON_MALLOC(8);
+		struct JSONArenaChunk* next = chunk->next;
+		JSON_FREE(chunk);
+		chunk = next;
 	}
+	arena->head = NULL;
+}
 
-	// Resize
-	if (ss->length + lstr + 1 > ss->size)
-	{
+// Frees everything allocated from the arena but keeps the newest and largest chunk to allocate from again
+static void json_arena_reset(struct JSONArena* arena)
+{
+	struct JSONArenaChunk* chunk = arena->head;
+	if (chunk == NULL)
+		return;
+	struct JSONArena older = {chunk->next, 0};
+	json_arena_free(&older);
+	chunk->next = NULL;
+	chunk->used = 0;
+}
 
-		ss->size = ss->size << (size_t)log2(lstr + 1);
-		char* tmp = JSON_REALLOC(ss->str, ss->size);
-		if (tmp == NULL)
-		{
-			JSON_MESSAGE("Failed to allocate memory for string stream");
-			return;
-		}
-		ss->str = tmp;
-	}
+// Allocates from the arena if not NULL, otherwise with JSON_MALLOC
+static void* json_alloc(struct JSONArena* arena, size_t size)
+{
+	if (arena)
+		return json_arena_alloc(arena, size);
+	return JSON_MALLOC(size);
+}
+
+struct JSONStringStream
+{
+	// The internal string pointer
+	char* str;
+	// The allocated size of the string
+	size_t size;
+	// How much has been written to the string
+	// Does not include the null terminator
+	size_t length;
+	// Set if growing the string or writing failed, everything written after is dropped
+	int failed;
+	// If set, the string is flushed here when full instead of grown
+	JSONWriteFn write;
+	void* ctx;
+#ifdef JSON_STATS
+	// How much has been flushed
+	size_t flushed;
+#endif
+};
 
-	// Copy data
-	memcpy(ss->str + ss->length, escape ? escaped_str : str, lstr);
-	ss->length += lstr;
-	// Null terminate
-	ss->str[ss->length] = '\0';
-	if (escape)
+// Passes everything written so far to the write function and empties the string
+static int json_ss_flush(struct JSONStringStream* ss)
+{
+	if (ss->write(ss->ctx, ss->str, ss->length))
 	{
-		JSON_FREE(escaped_str);
+		JSON_MESSAGE("Failed to write json");
+		ss->failed = 1;
+		return 0;
 	}
+#ifdef JSON_STATS
+	ss->flushed += ss->length;
+#endif
+	ss->length = 0;
+	return 1;
 }
 
-// Converts a double to a string
-// Precision indicates the max digits to include after the comma
-// Prints up to precision digits after the comma, can write less. Can be used to print integers, where the comma is not
-// written Returns how many characters were written
-static int json_ftos(double num, char* buf, int precision)
+// Makes room for n more characters and the null terminator
+// Returns 0 if the string couldn't be grown
+static int json_ss_reserve(struct JSONStringStream* ss, size_t n)
 {
-	if (isinf(num))
+	if (ss->length + n + 1 <= ss->size)
+		return 1;
+	if (ss->failed)
+		return 0;
+	if (ss->write && ss->length)
 	{
-		if (num < 0)
-			*buf++ = '-';
-		*buf++ = 'i';
-		*buf++ = 'n';
-		*buf++ = 'f';
-		*buf++ = '\0';
-		return num < 0 ? 4 : 3;
+		if (!json_ss_flush(ss))
+			return 0;
+		if (n + 1 <= ss->size)
+			return 1;
 	}
 
-	// Save the sign and remove it from num
-	int neg = num < 0;
-	if (neg)
-		num *= -1;
-	// Shift decimal to precision places to an int
-	size_t a = num * pow(10, precision + 1);
+	size_t size = ss->size ? ss->size * 2 : 256;
+	while (size < ss->length + n + 1)
+		size *= 2;
+	char* tmp = JSON_REALLOC(ss->str, size);
+	if (tmp == NULL)
+	{
+		JSON_MESSAGE("Failed to allocate memory for string stream");
+		ss->failed = 1;
+		return 0;
+	}
+	JSON_STATS_ALLOC(writer, size);
+	if (ss->str)
+		JSON_STATS_ADD(writer_grows, 1);
+	ss->str = tmp;
+	ss->size = size;
+	return 1;
+}
+
+// Writes len characters of str to the string stream
+static void json_ss_write(struct JSONStringStream* ss, const char* str, size_t len)
+{
+	if (!json_ss_reserve(ss, len))
+		return;
+	memcpy(ss->str + ss->length, str, len);
+	ss->length += len;
+}
+
+// Writes a string literal without measuring it
+#define json_ss_literal(ss, lit) json_ss_write(ss, lit, sizeof(lit) - 1)
+
+// Writes a newline followed by depth tabs
+static void json_ss_indent(struct JSONStringStream* ss, size_t depth)
+{
+	static const char tabs[] = "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+	if (!json_ss_reserve(ss, depth + 1))
+		return;
+	char* p = ss->str + ss->length;
+	*p++ = '\n';
+	ss->length += depth + 1;
+	for (; depth > sizeof tabs - 1; depth -= sizeof tabs - 1, p += sizeof tabs - 1)
+		memcpy(p, tabs, sizeof tabs - 1);
+	memcpy(p, tabs, depth);
+}
+
+// Returns the index of the lowest bit set in x, which must not be 0
+static int json_ctz64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(x);
+#else
+	int n = 0;
+	for (; !(x & 1); x >>= 1)
+		n++;
+	return n;
+#endif
+}
 
-	// Round initially
-	if (a % 10 >= 5)
-		a += 10;
-	a /= 10;
+#if !JSON_SSE2
+// Sets the high bit of every byte of the word x that is equal to c
+static uint64_t json_swar_equal(uint64_t x, unsigned char c)
+{
+	uint64_t t = x ^ (0x0101010101010101ull * c);
+	return ~(((t & 0x7F7F7F7F7F7F7F7Full) + 0x7F7F7F7F7F7F7F7Full) | t) & 0x8080808080808080ull;
+}
 
-	int dec_pos = precision;
+// Gathers the high bits of the bytes of x into the lowest 8 bits, the first byte in memory first
+static uint64_t json_swar_bits(uint64_t x)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	return (x >> 7) * 0x8040201008040201ull >> 56;
+#else
+	return (x >> 7) * 0x0102040810204080ull >> 56;
+#endif
+}
+#endif
 
-	// Carried the one, need to round once more
-	while (a % 10 == 0 && a && a > num)
+// Returns the first quote, backslash or control character from str, or end if there is none, and also the first
+// character outside ASCII if ascii is set
+// Characters are compared 16 at a time with SSE2, or 8 at a time within words otherwise
+static const char* json_find_special(const char* str, const char* end, int ascii)
+{
+#if JSON_SSE2
+	for (; end - str >= 16; str += 16)
 	{
-		if (a % 10 >= 5)
-			a += 10;
-		a /= 10;
-		dec_pos--;
+		__m128i c = _mm_loadu_si128((const __m128i*)str);
+		__m128i special = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('"')), _mm_cmpeq_epi8(c, _mm_set1_epi8('\\'))),
+			_mm_cmpeq_epi8(_mm_max_epu8(c, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F)));
+		if (ascii)
+			special = _mm_or_si128(special, c);
+		unsigned mask = _mm_movemask_epi8(special);
+		if (mask)
+			return str + json_ctz64(mask);
 	}
+#else
+	for (; end - str >= 8; str += 8)
+	{
+		uint64_t c;
+		memcpy(&c, str, sizeof c);
+		// The high bit of bytes below 0x20 stays clear when 0x60 is added to their lower 7 bits
+		uint64_t control = ~(((c & 0x7F7F7F7F7F7F7F7Full) + 0x6060606060606060ull) | c) & 0x8080808080808080ull;
+		uint64_t special = json_swar_equal(c, '"') | json_swar_equal(c, '\\') | control;
+		if (ascii)
+			special |= c & 0x8080808080808080ull;
+		if (special)
+			return str + json_ctz64(json_swar_bits(special));
+	}
+#endif
+	while (str < end && *str != '"' && *str != '\\' && (unsigned char)*str >= 0x20 &&
+		   (!ascii || (unsigned char)*str < 0x80))
+		str++;
+	return str;
+}
 
-	int base = 10;
-	char numerals[17] = {"0123456789ABCDEF"};
-
-	// Return and write one character if float == 0 to precision accuracy
-	if (a == 0)
+// Decodes the UTF-8 sequence at str into *code, rejecting overlong forms, surrogates and code points above U+10FFFF
+// Returns the length of the sequence, or 0 if it's invalid or cut off by end
+static int json_utf8_decode(const unsigned char* str, const unsigned char* end, uint32_t* code)
+{
+	unsigned char c = str[0];
+	int len;
+	uint32_t min;
+	if (c < 0x80)
 	{
-		*buf++ = '0';
-		*buf = '\0';
+		*code = c;
 		return 1;
 	}
+	else if (c >= 0xC2 && c <= 0xDF)
+	{
+		len = 2;
+		min = 0x80;
+		*code = c & 0x1F;
+	}
+	else if (c >= 0xE0 && c <= 0xEF)
+	{
+		len = 3;
+		min = 0x800;
+		*code = c & 0x0F;
+	}
+	else if (c >= 0xF0 && c <= 0xF4)
+	{
+		len = 4;
+		min = 0x10000;
+		*code = c & 0x07;
+	}
+	else
+		return 0;
 
-	size_t digitcount = log10(a) + 1;
-	size_t buf_index = digitcount + neg + (dec_pos >= digitcount ? dec_pos - digitcount + 1 : 0) + (dec_pos ? 1 : 0);
-	int return_value = buf_index;
-
-	buf[buf_index] = '\0';
-	while (buf_index)
+	if (end - str < len)
+		return 0;
+	for (int i = 1; i < len; i++)
 	{
-		buf[--buf_index] = numerals[a % base];
-		if (dec_pos == 1)
-			buf[--buf_index] = '.';
-		dec_pos--;
-		a /= base;
+		if ((str[i] & 0xC0) != 0x80)
+			return 0;
+		*code = *code << 6 | (str[i] & 0x3F);
 	}
-	if (neg)
-		*buf = '-';
-	return return_value;
+	if (*code < min || *code > 0x10FFFF || (*code >= 0xD800 && *code <= 0xDFFF))
+		return 0;
+	return len;
 }
 
-// Convert a json valid number representation from string to double
-static char* json_stof(char* str, double* out)
+// Writes the escape sequence \uXXXX of a code point below 0x10000 to out
+static void json_escape_code(char* out, uint32_t code)
 {
-	double result = 0;
-	// Signifies if read past period
-	int isfraction = 0;
-	// The value of the digit after period
-	double digitval = 1;
-	// Signifies if optional exponent is being read
-	int isexponent = 0;
-	// Value of exponent
-	int exponent = 0;
-	// The sign of the resulting value
-	int sign = 1;
-	if (*str == '-')
-	{
-		sign = -1;
-		str++;
-	}
+	static const char hex[] = "0123456789abcdef";
+	out[0] = '\\';
+	out[1] = 'u';
+	out[2] = hex[code >> 12 & 0xF];
+	out[3] = hex[code >> 8 & 0xF];
+	out[4] = hex[code >> 4 & 0xF];
+	out[5] = hex[code & 0xF];
+}
 
-	for (; *str != '\0'; str++)
+// The character after the backslash when escaping each byte, 0 if it's written as is, or u if it's written as \u00XX
+static const char json_escapes[256] = {'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+									   'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+									   ['"'] = '"', ['\\'] = '\\'};
+
+// Writes str in quotes, escaping quotes, backslashes and control characters, and every character outside ASCII as
+// \uXXXX or a surrogate pair if ascii is set
+// Room is made for the unescaped string up front, and only grown further when an escape sequence is hit
+static void json_ss_write_quoted(struct JSONStringStream* ss, const char* str, int ascii)
+{
+	size_t len = strlen(str);
+	const char* end = str + len;
+	if (!json_ss_reserve(ss, len + 2))
+		return;
+	char* out = ss->str + ss->length;
+	*out++ = '"';
+
+	for (const char* p = str; p < end; p++)
 	{
-		// Decimal place
-		if (*str == '.')
+		// Long runs of characters written as is are found and copied at once
+		if (end - p >= 16)
 		{
-			isfraction = 1;
-			continue;
+			const char* run = json_find_special(p, end, ascii);
+			memcpy(out, p, run - p);
+			out += run - p;
+			p = run;
+			if (p == end)
+				break;
 		}
 
-		// Exponent
-		if (*str == 'e' || *str == 'E')
+		unsigned char c = *p;
+		char escape = ascii && c >= 0x80 ? 'u' : json_escapes[c];
+		if (!escape)
 		{
-			if (isexponent)
-			{
-				JSON_MESSAGE("Can't have stacked exponents");
-				return 0;
-			}
-			isexponent = 1;
+			*out++ = c;
 			continue;
 		}
-		// End
-		// Keep comma and return
-		if (*str == ',')
-		{
-			break;
-		}
 
-		// Break when not a valid number
-		// Triggered when next char is end of object or array wihtout comma
-		if (*str < '0' || *str > '9')
+		// The escape sequences, the rest of the string, and the closing quote
+		ss->length = out - ss->str;
+		if (!json_ss_reserve(ss, 12 + (end - p)))
+			return;
+		out = ss->str + ss->length;
+		if (escape != 'u')
 		{
-			break;
+			*out++ = '\\';
+			*out++ = escape;
+			continue;
 		}
 
-		int digit = *str - '0';
-		if (isexponent)
+		// Invalid UTF-8 is written as the replacement character
+		uint32_t code = c;
+		if (c >= 0x80)
 		{
-			exponent *= 10;
-			exponent += digit;
+			int n = json_utf8_decode((const unsigned char*)p, (const unsigned char*)end, &code);
+			if (n == 0)
+				code = 0xFFFD;
+			else
+				p += n - 1;
 		}
-		else if (isfraction)
+		if (code >= 0x10000)
 		{
-			digitval *= 0.1;
-			result += digit * digitval;
-		}
-		// Normal digit
-		else
-		{
-			result *= 10;
-			result += digit;
+			code -= 0x10000;
+			json_escape_code(out, 0xD800 | code >> 10);
+			out += 6;
+			code = 0xDC00 | (code & 0x3FF);
 		}
+		json_escape_code(out, code);
+		out += 6;
 	}
-	result *= sign;
-	if (exponent != 0)
-		*out = result * powf(10, exponent);
-	else
-		*out = result;
-	return str;
+	*out++ = '"';
+	ss->length = out - ss->str;
 }
 
-// Reads from start quote to end quote and takes escape characters into consideration
-// Allocates memory for output string; need to be freed manually
-static char* json_read_quote(char* str, char** out)
-{
-	// Skip past start quote
-	while (*str != '"')
-		str++;
-	str++;
+// Set if the node is not a child of an object or array and owns its name
+#define JSON_FLAG_NAME 1
+// Set if the number is stored exactly as a 64 bit integer in intval instead of numval
+#define JSON_FLAG_INTEGER 2
+// Set if the name of the member is shared and not freed with it
+#define JSON_FLAG_SHARED 4
 
-	// Iterator for the object stringval
-	size_t lval = 8;
-	*out = JSON_MALLOC(lval);
-	char* result = *out;
-	size_t valit = 0;
-	// Loop to end of quote
-	for (; *str != '\0'; str++)
-	{
+struct JSON
+{
+	unsigned char type;
+	unsigned char flags;
+	// The position in the children of the parent
+	unsigned int pos;
+	union
+	{
+		// The object or array this is a member or element of
+		struct JSON* parent;
+		// The name of a node that isn't a child, if JSON_FLAG_NAME is set
+		char* name;
+	} up;
+	union
+	{
+		double numval;
+		int64_t intval;
+		char* stringval;
+		// The members or elements of an object or array, NULL if empty
+		struct JSONChildren* children;
+	} val;
+};
+
+// Range of powers of ten covered by json_pow5_128
+// Smaller powers round to zero and larger to infinity for any mantissa of up to 19 digits
+#define JSON_POW10_MIN -342
+#define JSON_POW10_MAX 308
+
+// The 128 most significant bits of 5^q for JSON_POW10_MIN <= q <= JSON_POW10_MAX, as high and low halves
+// Used by the Eisel-Lemire conversion, see "Number Parsing at a Gigabyte per Second" by Daniel Lemire
+static const uint64_t json_pow5_128[][2] = {
+	{0xeef453d6923bd65a, 0x113faa2906a13b3f}, {0x9558b4661b6565f8, 0x4ac7ca59a424c507},
+	{0xbaaee17fa23ebf76, 0x5d79bcf00d2df649}, {0xe95a99df8ace6f53, 0xf4d82c2c107973dc},
+	{0x91d8a02bb6c10594, 0x79071b9b8a4be869}, {0xb64ec836a47146f9, 0x9748e2826cdee284},
+	{0xe3e27a444d8d98b7, 0xfd1b1b2308169b25}, {0x8e6d8c6ab0787f72, 0xfe30f0f5e50e20f7},
+	{0xb208ef855c969f4f, 0xbdbd2d335e51a935}, {0xde8b2b66b3bc4723, 0xad2c788035e61382},
+	{0x8b16fb203055ac76, 0x4c3bcb5021afcc31}, {0xaddcb9e83c6b1793, 0xdf4abe242a1bbf3d},
+	{0xd953e8624b85dd78, 0xd71d6dad34a2af0d}, {0x87d4713d6f33aa6b, 0x8672648c40e5ad68},
+	{0xa9c98d8ccb009506, 0x680efdaf511f18c2}, {0xd43bf0effdc0ba48, 0x0212bd1b2566def2},
+	{0x84a57695fe98746d, 0x014bb630f7604b57}, {0xa5ced43b7e3e9188, 0x419ea3bd35385e2d},
+	{0xcf42894a5dce35ea, 0x52064cac828675b9}, {0x818995ce7aa0e1b2, 0x7343efebd1940993},
+	{0xa1ebfb4219491a1f, 0x1014ebe6c5f90bf8}, {0xca66fa129f9b60a6, 0xd41a26e077774ef6},
+	{0xfd00b897478238d0, 0x8920b098955522b4}, {0x9e20735e8cb16382, 0x55b46e5f5d5535b0},
+	{0xc5a890362fddbc62, 0xeb2189f734aa831d}, {0xf712b443bbd52b7b, 0xa5e9ec7501d523e4},
+	{0x9a6bb0aa55653b2d, 0x47b233c92125366e}, {0xc1069cd4eabe89f8, 0x999ec0bb696e840a},
+	{0xf148440a256e2c76, 0xc00670ea43ca250d}, {0x96cd2a865764dbca, 0x380406926a5e5728},
+	{0xbc807527ed3e12bc, 0xc605083704f5ecf2}, {0xeba09271e88d976b, 0xf7864a44c633682e},
+	{0x93445b8731587ea3, 0x7ab3ee6afbe0211d}, {0xb8157268fdae9e4c, 0x5960ea05bad82964},
+	{0xe61acf033d1a45df, 0x6fb92487298e33bd}, {0x8fd0c16206306bab, 0xa5d3b6d479f8e056},
+	{0xb3c4f1ba87bc8696, 0x8f48a4899877186c}, {0xe0b62e2929aba83c, 0x331acdabfe94de87},
+	{0x8c71dcd9ba0b4925, 0x9ff0c08b7f1d0b14}, {0xaf8e5410288e1b6f, 0x07ecf0ae5ee44dd9},
+	{0xdb71e91432b1a24a, 0xc9e82cd9f69d6150}, {0x892731ac9faf056e, 0xbe311c083a225cd2},
+	{0xab70fe17c79ac6ca, 0x6dbd630a48aaf406}, {0xd64d3d9db981787d, 0x092cbbccdad5b108},
+	{0x85f0468293f0eb4e, 0x25bbf56008c58ea5}, {0xa76c582338ed2621, 0xaf2af2b80af6f24e},
+	{0xd1476e2c07286faa, 0x1af5af660db4aee1}, {0x82cca4db847945ca, 0x50d98d9fc890ed4d},
+	{0xa37fce126597973c, 0xe50ff107bab528a0}, {0xcc5fc196fefd7d0c, 0x1e53ed49a96272c8},
+	{0xff77b1fcbebcdc4f, 0x25e8e89c13bb0f7a}, {0x9faacf3df73609b1, 0x77b191618c54e9ac},
+	{0xc795830d75038c1d, 0xd59df5b9ef6a2417}, {0xf97ae3d0d2446f25, 0x4b0573286b44ad1d},
+	{0x9becce62836ac577, 0x4ee367f9430aec32}, {0xc2e801fb244576d5, 0x229c41f793cda73f},
+	{0xf3a20279ed56d48a, 0x6b43527578c1110f}, {0x9845418c345644d6, 0x830a13896b78aaa9},
+	{0xbe5691ef416bd60c, 0x23cc986bc656d553}, {0xedec366b11c6cb8f, 0x2cbfbe86b7ec8aa8},
+	{0x94b3a202eb1c3f39, 0x7bf7d71432f3d6a9}, {0xb9e08a83a5e34f07, 0xdaf5ccd93fb0cc53},
+	{0xe858ad248f5c22c9, 0xd1b3400f8f9cff68}, {0x91376c36d99995be, 0x23100809b9c21fa1},
+	{0xb58547448ffffb2d, 0xabd40a0c2832a78a}, {0xe2e69915b3fff9f9, 0x16c90c8f323f516c},
+	{0x8dd01fad907ffc3b, 0xae3da7d97f6792e3}, {0xb1442798f49ffb4a, 0x99cd11cfdf41779c},
+	{0xdd95317f31c7fa1d, 0x40405643d711d583}, {0x8a7d3eef7f1cfc52, 0x482835ea666b2572},
+	{0xad1c8eab5ee43b66, 0xda3243650005eecf}, {0xd863b256369d4a40, 0x90bed43e40076a82},
+	{0x873e4f75e2224e68, 0x5a7744a6e804a291}, {0xa90de3535aaae202, 0x711515d0a205cb36},
+	{0xd3515c2831559a83, 0x0d5a5b44ca873e03}, {0x8412d9991ed58091, 0xe858790afe9486c2},
+	{0xa5178fff668ae0b6, 0x626e974dbe39a872}, {0xce5d73ff402d98e3, 0xfb0a3d212dc8128f},
+	{0x80fa687f881c7f8e, 0x7ce66634bc9d0b99}, {0xa139029f6a239f72, 0x1c1fffc1ebc44e80},
+	{0xc987434744ac874e, 0xa327ffb266b56220}, {0xfbe9141915d7a922, 0x4bf1ff9f0062baa8},
+	{0x9d71ac8fada6c9b5, 0x6f773fc3603db4a9}, {0xc4ce17b399107c22, 0xcb550fb4384d21d3},
+	{0xf6019da07f549b2b, 0x7e2a53a146606a48}, {0x99c102844f94e0fb, 0x2eda7444cbfc426d},
+	{0xc0314325637a1939, 0xfa911155fefb5308}, {0xf03d93eebc589f88, 0x793555ab7eba27ca},
+	{0x96267c7535b763b5, 0x4bc1558b2f3458de}, {0xbbb01b9283253ca2, 0x9eb1aaedfb016f16},
+	{0xea9c227723ee8bcb, 0x465e15a979c1cadc}, {0x92a1958a7675175f, 0x0bfacd89ec191ec9},
+	{0xb749faed14125d36, 0xcef980ec671f667b}, {0xe51c79a85916f484, 0x82b7e12780e7401a},
+	{0x8f31cc0937ae58d2, 0xd1b2ecb8b0908810}, {0xb2fe3f0b8599ef07, 0x861fa7e6dcb4aa15},
+	{0xdfbdcece67006ac9, 0x67a791e093e1d49a}, {0x8bd6a141006042bd, 0xe0c8bb2c5c6d24e0},
+	{0xaecc49914078536d, 0x58fae9f773886e18}, {0xda7f5bf590966848, 0xaf39a475506a899e},
+	{0x888f99797a5e012d, 0x6d8406c952429603}, {0xaab37fd7d8f58178, 0xc8e5087ba6d33b83},
+	{0xd5605fcdcf32e1d6, 0xfb1e4a9a90880a64}, {0x855c3be0a17fcd26, 0x5cf2eea09a55067f},
+	{0xa6b34ad8c9dfc06f, 0xf42faa48c0ea481e}, {0xd0601d8efc57b08b, 0xf13b94daf124da26},
+	{0x823c12795db6ce57, 0x76c53d08d6b70858}, {0xa2cb1717b52481ed, 0x54768c4b0c64ca6e},
+	{0xcb7ddcdda26da268, 0xa9942f5dcf7dfd09}, {0xfe5d54150b090b02, 0xd3f93b35435d7c4c},
+	{0x9efa548d26e5a6e1, 0xc47bc5014a1a6daf}, {0xc6b8e9b0709f109a, 0x359ab6419ca1091b},
+	{0xf867241c8cc6d4c0, 0xc30163d203c94b62}, {0x9b407691d7fc44f8, 0x79e0de63425dcf1d},
+	{0xc21094364dfb5636, 0x985915fc12f542e4}, {0xf294b943e17a2bc4, 0x3e6f5b7b17b2939d},
+	{0x979cf3ca6cec5b5a, 0xa705992ceecf9c42}, {0xbd8430bd08277231, 0x50c6ff782a838353},
+	{0xece53cec4a314ebd, 0xa4f8bf5635246428}, {0x940f4613ae5ed136, 0x871b7795e136be99},
+	{0xb913179899f68584, 0x28e2557b59846e3f}, {0xe757dd7ec07426e5, 0x331aeada2fe589cf},
+	{0x9096ea6f3848984f, 0x3ff0d2c85def7621}, {0xb4bca50b065abe63, 0x0fed077a756b53a9},
+	{0xe1ebce4dc7f16dfb, 0xd3e8495912c62894}, {0x8d3360f09cf6e4bd, 0x64712dd7abbbd95c},
+	{0xb080392cc4349dec, 0xbd8d794d96aacfb3}, {0xdca04777f541c567, 0xecf0d7a0fc5583a0},
+	{0x89e42caaf9491b60, 0xf41686c49db57244}, {0xac5d37d5b79b6239, 0x311c2875c522ced5},
+	{0xd77485cb25823ac7, 0x7d633293366b828b}, {0x86a8d39ef77164bc, 0xae5dff9c02033197},
+	{0xa8530886b54dbdeb, 0xd9f57f830283fdfc}, {0xd267caa862a12d66, 0xd072df63c324fd7b},
+	{0x8380dea93da4bc60, 0x4247cb9e59f71e6d}, {0xa46116538d0deb78, 0x52d9be85f074e608},
+	{0xcd795be870516656, 0x67902e276c921f8b}, {0x806bd9714632dff6, 0x00ba1cd8a3db53b6},
+	{0xa086cfcd97bf97f3, 0x80e8a40eccd228a4}, {0xc8a883c0fdaf7df0, 0x6122cd128006b2cd},
+	{0xfad2a4b13d1b5d6c, 0x796b805720085f81}, {0x9cc3a6eec6311a63, 0xcbe3303674053bb0},
+	{0xc3f490aa77bd60fc, 0xbedbfc4411068a9c}, {0xf4f1b4d515acb93b, 0xee92fb5515482d44},
+	{0x991711052d8bf3c5, 0x751bdd152d4d1c4a}, {0xbf5cd54678eef0b6, 0xd262d45a78a0635d},
+	{0xef340a98172aace4, 0x86fb897116c87c34}, {0x9580869f0e7aac0e, 0xd45d35e6ae3d4da0},
+	{0xbae0a846d2195712, 0x8974836059cca109}, {0xe998d258869facd7, 0x2bd1a438703fc94b},
+	{0x91ff83775423cc06, 0x7b6306a34627ddcf}, {0xb67f6455292cbf08, 0x1a3bc84c17b1d542},
+	{0xe41f3d6a7377eeca, 0x20caba5f1d9e4a93}, {0x8e938662882af53e, 0x547eb47b7282ee9c},
+	{0xb23867fb2a35b28d, 0xe99e619a4f23aa43}, {0xdec681f9f4c31f31, 0x6405fa00e2ec94d4},
+	{0x8b3c113c38f9f37e, 0xde83bc408dd3dd04}, {0xae0b158b4738705e, 0x9624ab50b148d445},
+	{0xd98ddaee19068c76, 0x3badd624dd9b0957}, {0x87f8a8d4cfa417c9, 0xe54ca5d70a80e5d6},
+	{0xa9f6d30a038d1dbc, 0x5e9fcf4ccd211f4c}, {0xd47487cc8470652b, 0x7647c3200069671f},
+	{0x84c8d4dfd2c63f3b, 0x29ecd9f40041e073}, {0xa5fb0a17c777cf09, 0xf468107100525890},
+	{0xcf79cc9db955c2cc, 0x7182148d4066eeb4}, {0x81ac1fe293d599bf, 0xc6f14cd848405530},
+	{0xa21727db38cb002f, 0xb8ada00e5a506a7c}, {0xca9cf1d206fdc03b, 0xa6d90811f0e4851c},
+	{0xfd442e4688bd304a, 0x908f4a166d1da663}, {0x9e4a9cec15763e2e, 0x9a598e4e043287fe},
+	{0xc5dd44271ad3cdba, 0x40eff1e1853f29fd}, {0xf7549530e188c128, 0xd12bee59e68ef47c},
+	{0x9a94dd3e8cf578b9, 0x82bb74f8301958ce}, {0xc13a148e3032d6e7, 0xe36a52363c1faf01},
+	{0xf18899b1bc3f8ca1, 0xdc44e6c3cb279ac1}, {0x96f5600f15a7b7e5, 0x29ab103a5ef8c0b9},
+	{0xbcb2b812db11a5de, 0x7415d448f6b6f0e7}, {0xebdf661791d60f56, 0x111b495b3464ad21},
+	{0x936b9fcebb25c995, 0xcab10dd900beec34}, {0xb84687c269ef3bfb, 0x3d5d514f40eea742},
+	{0xe65829b3046b0afa, 0x0cb4a5a3112a5112}, {0x8ff71a0fe2c2e6dc, 0x47f0e785eaba72ab},
+	{0xb3f4e093db73a093, 0x59ed216765690f56}, {0xe0f218b8d25088b8, 0x306869c13ec3532c},
+	{0x8c974f7383725573, 0x1e414218c73a13fb}, {0xafbd2350644eeacf, 0xe5d1929ef90898fa},
+	{0xdbac6c247d62a583, 0xdf45f746b74abf39}, {0x894bc396ce5da772, 0x6b8bba8c328eb783},
+	{0xab9eb47c81f5114f, 0x066ea92f3f326564}, {0xd686619ba27255a2, 0xc80a537b0efefebd},
+	{0x8613fd0145877585, 0xbd06742ce95f5f36}, {0xa798fc4196e952e7, 0x2c48113823b73704},
+	{0xd17f3b51fca3a7a0, 0xf75a15862ca504c5}, {0x82ef85133de648c4, 0x9a984d73dbe722fb},
+	{0xa3ab66580d5fdaf5, 0xc13e60d0d2e0ebba}, {0xcc963fee10b7d1b3, 0x318df905079926a8},
+	{0xffbbcfe994e5c61f, 0xfdf17746497f7052}, {0x9fd561f1fd0f9bd3, 0xfeb6ea8bedefa633},
+	{0xc7caba6e7c5382c8, 0xfe64a52ee96b8fc0}, {0xf9bd690a1b68637b, 0x3dfdce7aa3c673b0},
+	{0x9c1661a651213e2d, 0x06bea10ca65c084e}, {0xc31bfa0fe5698db8, 0x486e494fcff30a62},
+	{0xf3e2f893dec3f126, 0x5a89dba3c3efccfa}, {0x986ddb5c6b3a76b7, 0xf89629465a75e01c},
+	{0xbe89523386091465, 0xf6bbb397f1135823}, {0xee2ba6c0678b597f, 0x746aa07ded582e2c},
+	{0x94db483840b717ef, 0xa8c2a44eb4571cdc}, {0xba121a4650e4ddeb, 0x92f34d62616ce413},
+	{0xe896a0d7e51e1566, 0x77b020baf9c81d17}, {0x915e2486ef32cd60, 0x0ace1474dc1d122e},
+	{0xb5b5ada8aaff80b8, 0x0d819992132456ba}, {0xe3231912d5bf60e6, 0x10e1fff697ed6c69},
+	{0x8df5efabc5979c8f, 0xca8d3ffa1ef463c1}, {0xb1736b96b6fd83b3, 0xbd308ff8a6b17cb2},
+	{0xddd0467c64bce4a0, 0xac7cb3f6d05ddbde}, {0x8aa22c0dbef60ee4, 0x6bcdf07a423aa96b},
+	{0xad4ab7112eb3929d, 0x86c16c98d2c953c6}, {0xd89d64d57a607744, 0xe871c7bf077ba8b7},
+	{0x87625f056c7c4a8b, 0x11471cd764ad4972}, {0xa93af6c6c79b5d2d, 0xd598e40d3dd89bcf},
+	{0xd389b47879823479, 0x4aff1d108d4ec2c3}, {0x843610cb4bf160cb, 0xcedf722a585139ba},
+	{0xa54394fe1eedb8fe, 0xc2974eb4ee658828}, {0xce947a3da6a9273e, 0x733d226229feea32},
+	{0x811ccc668829b887, 0x0806357d5a3f525f}, {0xa163ff802a3426a8, 0xca07c2dcb0cf26f7},
+	{0xc9bcff6034c13052, 0xfc89b393dd02f0b5}, {0xfc2c3f3841f17c67, 0xbbac2078d443ace2},
+	{0x9d9ba7832936edc0, 0xd54b944b84aa4c0d}, {0xc5029163f384a931, 0x0a9e795e65d4df11},
+	{0xf64335bcf065d37d, 0x4d4617b5ff4a16d5}, {0x99ea0196163fa42e, 0x504bced1bf8e4e45},
+	{0xc06481fb9bcf8d39, 0xe45ec2862f71e1d6}, {0xf07da27a82c37088, 0x5d767327bb4e5a4c},
+	{0x964e858c91ba2655, 0x3a6a07f8d510f86f}, {0xbbe226efb628afea, 0x890489f70a55368b},
+	{0xeadab0aba3b2dbe5, 0x2b45ac74ccea842e}, {0x92c8ae6b464fc96f, 0x3b0b8bc90012929d},
+	{0xb77ada0617e3bbcb, 0x09ce6ebb40173744}, {0xe55990879ddcaabd, 0xcc420a6a101d0515},
+	{0x8f57fa54c2a9eab6, 0x9fa946824a12232d}, {0xb32df8e9f3546564, 0x47939822dc96abf9},
+	{0xdff9772470297ebd, 0x59787e2b93bc56f7}, {0x8bfbea76c619ef36, 0x57eb4edb3c55b65a},
+	{0xaefae51477a06b03, 0xede622920b6b23f1}, {0xdab99e59958885c4, 0xe95fab368e45eced},
+	{0x88b402f7fd75539b, 0x11dbcb0218ebb414}, {0xaae103b5fcd2a881, 0xd652bdc29f26a119},
+	{0xd59944a37c0752a2, 0x4be76d3346f0495f}, {0x857fcae62d8493a5, 0x6f70a4400c562ddb},
+	{0xa6dfbd9fb8e5b88e, 0xcb4ccd500f6bb952}, {0xd097ad07a71f26b2, 0x7e2000a41346a7a7},
+	{0x825ecc24c873782f, 0x8ed400668c0c28c8}, {0xa2f67f2dfa90563b, 0x728900802f0f32fa},
+	{0xcbb41ef979346bca, 0x4f2b40a03ad2ffb9}, {0xfea126b7d78186bc, 0xe2f610c84987bfa8},
+	{0x9f24b832e6b0f436, 0x0dd9ca7d2df4d7c9}, {0xc6ede63fa05d3143, 0x91503d1c79720dbb},
+	{0xf8a95fcf88747d94, 0x75a44c6397ce912a}, {0x9b69dbe1b548ce7c, 0xc986afbe3ee11aba},
+	{0xc24452da229b021b, 0xfbe85badce996168}, {0xf2d56790ab41c2a2, 0xfae27299423fb9c3},
+	{0x97c560ba6b0919a5, 0xdccd879fc967d41a}, {0xbdb6b8e905cb600f, 0x5400e987bbc1c920},
+	{0xed246723473e3813, 0x290123e9aab23b68}, {0x9436c0760c86e30b, 0xf9a0b6720aaf6521},
+	{0xb94470938fa89bce, 0xf808e40e8d5b3e69}, {0xe7958cb87392c2c2, 0xb60b1d1230b20e04},
+	{0x90bd77f3483bb9b9, 0xb1c6f22b5e6f48c2}, {0xb4ecd5f01a4aa828, 0x1e38aeb6360b1af3},
+	{0xe2280b6c20dd5232, 0x25c6da63c38de1b0}, {0x8d590723948a535f, 0x579c487e5a38ad0e},
+	{0xb0af48ec79ace837, 0x2d835a9df0c6d851}, {0xdcdb1b2798182244, 0xf8e431456cf88e65},
+	{0x8a08f0f8bf0f156b, 0x1b8e9ecb641b58ff}, {0xac8b2d36eed2dac5, 0xe272467e3d222f3f},
+	{0xd7adf884aa879177, 0x5b0ed81dcc6abb0f}, {0x86ccbb52ea94baea, 0x98e947129fc2b4e9},
+	{0xa87fea27a539e9a5, 0x3f2398d747b36224}, {0xd29fe4b18e88640e, 0x8eec7f0d19a03aad},
+	{0x83a3eeeef9153e89, 0x1953cf68300424ac}, {0xa48ceaaab75a8e2b, 0x5fa8c3423c052dd7},
+	{0xcdb02555653131b6, 0x3792f412cb06794d}, {0x808e17555f3ebf11, 0xe2bbd88bbee40bd0},
+	{0xa0b19d2ab70e6ed6, 0x5b6aceaeae9d0ec4}, {0xc8de047564d20a8b, 0xf245825a5a445275},
+	{0xfb158592be068d2e, 0xeed6e2f0f0d56712}, {0x9ced737bb6c4183d, 0x55464dd69685606b},
+	{0xc428d05aa4751e4c, 0xaa97e14c3c26b886}, {0xf53304714d9265df, 0xd53dd99f4b3066a8},
+	{0x993fe2c6d07b7fab, 0xe546a8038efe4029}, {0xbf8fdb78849a5f96, 0xde98520472bdd033},
+	{0xef73d256a5c0f77c, 0x963e66858f6d4440}, {0x95a8637627989aad, 0xdde7001379a44aa8},
+	{0xbb127c53b17ec159, 0x5560c018580d5d52}, {0xe9d71b689dde71af, 0xaab8f01e6e10b4a6},
+	{0x9226712162ab070d, 0xcab3961304ca70e8}, {0xb6b00d69bb55c8d1, 0x3d607b97c5fd0d22},
+	{0xe45c10c42a2b3b05, 0x8cb89a7db77c506a}, {0x8eb98a7a9a5b04e3, 0x77f3608e92adb242},
+	{0xb267ed1940f1c61c, 0x55f038b237591ed3}, {0xdf01e85f912e37a3, 0x6b6c46dec52f6688},
+	{0x8b61313bbabce2c6, 0x2323ac4b3b3da015}, {0xae397d8aa96c1b77, 0xabec975e0a0d081a},
+	{0xd9c7dced53c72255, 0x96e7bd358c904a21}, {0x881cea14545c7575, 0x7e50d64177da2e54},
+	{0xaa242499697392d2, 0xdde50bd1d5d0b9e9}, {0xd4ad2dbfc3d07787, 0x955e4ec64b44e864},
+	{0x84ec3c97da624ab4, 0xbd5af13bef0b113e}, {0xa6274bbdd0fadd61, 0xecb1ad8aeacdd58e},
+	{0xcfb11ead453994ba, 0x67de18eda5814af2}, {0x81ceb32c4b43fcf4, 0x80eacf948770ced7},
+	{0xa2425ff75e14fc31, 0xa1258379a94d028d}, {0xcad2f7f5359a3b3e, 0x096ee45813a04330},
+	{0xfd87b5f28300ca0d, 0x8bca9d6e188853fc}, {0x9e74d1b791e07e48, 0x775ea264cf55347e},
+	{0xc612062576589dda, 0x95364afe032a819e}, {0xf79687aed3eec551, 0x3a83ddbd83f52205},
+	{0x9abe14cd44753b52, 0xc4926a9672793543}, {0xc16d9a0095928a27, 0x75b7053c0f178294},
+	{0xf1c90080baf72cb1, 0x5324c68b12dd6339}, {0x971da05074da7bee, 0xd3f6fc16ebca5e04},
+	{0xbce5086492111aea, 0x88f4bb1ca6bcf585}, {0xec1e4a7db69561a5, 0x2b31e9e3d06c32e6},
+	{0x9392ee8e921d5d07, 0x3aff322e62439fd0}, {0xb877aa3236a4b449, 0x09befeb9fad487c3},
+	{0xe69594bec44de15b, 0x4c2ebe687989a9b4}, {0x901d7cf73ab0acd9, 0x0f9d37014bf60a11},
+	{0xb424dc35095cd80f, 0x538484c19ef38c95}, {0xe12e13424bb40e13, 0x2865a5f206b06fba},
+	{0x8cbccc096f5088cb, 0xf93f87b7442e45d4}, {0xafebff0bcb24aafe, 0xf78f69a51539d749},
+	{0xdbe6fecebdedd5be, 0xb573440e5a884d1c}, {0x89705f4136b4a597, 0x31680a88f8953031},
+	{0xabcc77118461cefc, 0xfdc20d2b36ba7c3e}, {0xd6bf94d5e57a42bc, 0x3d32907604691b4d},
+	{0x8637bd05af6c69b5, 0xa63f9a49c2c1b110}, {0xa7c5ac471b478423, 0x0fcf80dc33721d54},
+	{0xd1b71758e219652b, 0xd3c36113404ea4a9}, {0x83126e978d4fdf3b, 0x645a1cac083126ea},
+	{0xa3d70a3d70a3d70a, 0x3d70a3d70a3d70a4}, {0xcccccccccccccccc, 0xcccccccccccccccd},
+	{0x8000000000000000, 0x0000000000000000}, {0xa000000000000000, 0x0000000000000000},
+	{0xc800000000000000, 0x0000000000000000}, {0xfa00000000000000, 0x0000000000000000},
+	{0x9c40000000000000, 0x0000000000000000}, {0xc350000000000000, 0x0000000000000000},
+	{0xf424000000000000, 0x0000000000000000}, {0x9896800000000000, 0x0000000000000000},
+	{0xbebc200000000000, 0x0000000000000000}, {0xee6b280000000000, 0x0000000000000000},
+	{0x9502f90000000000, 0x0000000000000000}, {0xba43b74000000000, 0x0000000000000000},
+	{0xe8d4a51000000000, 0x0000000000000000}, {0x9184e72a00000000, 0x0000000000000000},
+	{0xb5e620f480000000, 0x0000000000000000}, {0xe35fa931a0000000, 0x0000000000000000},
+	{0x8e1bc9bf04000000, 0x0000000000000000}, {0xb1a2bc2ec5000000, 0x0000000000000000},
+	{0xde0b6b3a76400000, 0x0000000000000000}, {0x8ac7230489e80000, 0x0000000000000000},
+	{0xad78ebc5ac620000, 0x0000000000000000}, {0xd8d726b7177a8000, 0x0000000000000000},
+	{0x878678326eac9000, 0x0000000000000000}, {0xa968163f0a57b400, 0x0000000000000000},
+	{0xd3c21bcecceda100, 0x0000000000000000}, {0x84595161401484a0, 0x0000000000000000},
+	{0xa56fa5b99019a5c8, 0x0000000000000000}, {0xcecb8f27f4200f3a, 0x0000000000000000},
+	{0x813f3978f8940984, 0x4000000000000000}, {0xa18f07d736b90be5, 0x5000000000000000},
+	{0xc9f2c9cd04674ede, 0xa400000000000000}, {0xfc6f7c4045812296, 0x4d00000000000000},
+	{0x9dc5ada82b70b59d, 0xf020000000000000}, {0xc5371912364ce305, 0x6c28000000000000},
+	{0xf684df56c3e01bc6, 0xc732000000000000}, {0x9a130b963a6c115c, 0x3c7f400000000000},
+	{0xc097ce7bc90715b3, 0x4b9f100000000000}, {0xf0bdc21abb48db20, 0x1e86d40000000000},
+	{0x96769950b50d88f4, 0x1314448000000000}, {0xbc143fa4e250eb31, 0x17d955a000000000},
+	{0xeb194f8e1ae525fd, 0x5dcfab0800000000}, {0x92efd1b8d0cf37be, 0x5aa1cae500000000},
+	{0xb7abc627050305ad, 0xf14a3d9e40000000}, {0xe596b7b0c643c719, 0x6d9ccd05d0000000},
+	{0x8f7e32ce7bea5c6f, 0xe4820023a2000000}, {0xb35dbf821ae4f38b, 0xdda2802c8a800000},
+	{0xe0352f62a19e306e, 0xd50b2037ad200000}, {0x8c213d9da502de45, 0x4526f422cc340000},
+	{0xaf298d050e4395d6, 0x9670b12b7f410000}, {0xdaf3f04651d47b4c, 0x3c0cdd765f114000},
+	{0x88d8762bf324cd0f, 0xa5880a69fb6ac800}, {0xab0e93b6efee0053, 0x8eea0d047a457a00},
+	{0xd5d238a4abe98068, 0x72a4904598d6d880}, {0x85a36366eb71f041, 0x47a6da2b7f864750},
+	{0xa70c3c40a64e6c51, 0x999090b65f67d924}, {0xd0cf4b50cfe20765, 0xfff4b4e3f741cf6d},
+	{0x82818f1281ed449f, 0xbff8f10e7a8921a4}, {0xa321f2d7226895c7, 0xaff72d52192b6a0d},
+	{0xcbea6f8ceb02bb39, 0x9bf4f8a69f764490}, {0xfee50b7025c36a08, 0x02f236d04753d5b4},
+	{0x9f4f2726179a2245, 0x01d762422c946590}, {0xc722f0ef9d80aad6, 0x424d3ad2b7b97ef5},
+	{0xf8ebad2b84e0d58b, 0xd2e0898765a7deb2}, {0x9b934c3b330c8577, 0x63cc55f49f88eb2f},
+	{0xc2781f49ffcfa6d5, 0x3cbf6b71c76b25fb}, {0xf316271c7fc3908a, 0x8bef464e3945ef7a},
+	{0x97edd871cfda3a56, 0x97758bf0e3cbb5ac}, {0xbde94e8e43d0c8ec, 0x3d52eeed1cbea317},
+	{0xed63a231d4c4fb27, 0x4ca7aaa863ee4bdd}, {0x945e455f24fb1cf8, 0x8fe8caa93e74ef6a},
+	{0xb975d6b6ee39e436, 0xb3e2fd538e122b44}, {0xe7d34c64a9c85d44, 0x60dbbca87196b616},
+	{0x90e40fbeea1d3a4a, 0xbc8955e946fe31cd}, {0xb51d13aea4a488dd, 0x6babab6398bdbe41},
+	{0xe264589a4dcdab14, 0xc696963c7eed2dd1}, {0x8d7eb76070a08aec, 0xfc1e1de5cf543ca2},
+	{0xb0de65388cc8ada8, 0x3b25a55f43294bcb}, {0xdd15fe86affad912, 0x49ef0eb713f39ebe},
+	{0x8a2dbf142dfcc7ab, 0x6e3569326c784337}, {0xacb92ed9397bf996, 0x49c2c37f07965404},
+	{0xd7e77a8f87daf7fb, 0xdc33745ec97be906}, {0x86f0ac99b4e8dafd, 0x69a028bb3ded71a3},
+	{0xa8acd7c0222311bc, 0xc40832ea0d68ce0c}, {0xd2d80db02aabd62b, 0xf50a3fa490c30190},
+	{0x83c7088e1aab65db, 0x792667c6da79e0fa}, {0xa4b8cab1a1563f52, 0x577001b891185938},
+	{0xcde6fd5e09abcf26, 0xed4c0226b55e6f86}, {0x80b05e5ac60b6178, 0x544f8158315b05b4},
+	{0xa0dc75f1778e39d6, 0x696361ae3db1c721}, {0xc913936dd571c84c, 0x03bc3a19cd1e38e9},
+	{0xfb5878494ace3a5f, 0x04ab48a04065c723}, {0x9d174b2dcec0e47b, 0x62eb0d64283f9c76},
+	{0xc45d1df942711d9a, 0x3ba5d0bd324f8394}, {0xf5746577930d6500, 0xca8f44ec7ee36479},
+	{0x9968bf6abbe85f20, 0x7e998b13cf4e1ecb}, {0xbfc2ef456ae276e8, 0x9e3fedd8c321a67e},
+	{0xefb3ab16c59b14a2, 0xc5cfe94ef3ea101e}, {0x95d04aee3b80ece5, 0xbba1f1d158724a12},
+	{0xbb445da9ca61281f, 0x2a8a6e45ae8edc97}, {0xea1575143cf97226, 0xf52d09d71a3293bd},
+	{0x924d692ca61be758, 0x593c2626705f9c56}, {0xb6e0c377cfa2e12e, 0x6f8b2fb00c77836c},
+	{0xe498f455c38b997a, 0x0b6dfb9c0f956447}, {0x8edf98b59a373fec, 0x4724bd4189bd5eac},
+	{0xb2977ee300c50fe7, 0x58edec91ec2cb657}, {0xdf3d5e9bc0f653e1, 0x2f2967b66737e3ed},
+	{0x8b865b215899f46c, 0xbd79e0d20082ee74}, {0xae67f1e9aec07187, 0xecd8590680a3aa11},
+	{0xda01ee641a708de9, 0xe80e6f4820cc9495}, {0x884134fe908658b2, 0x3109058d147fdcdd},
+	{0xaa51823e34a7eede, 0xbd4b46f0599fd415}, {0xd4e5e2cdc1d1ea96, 0x6c9e18ac7007c91a},
+	{0x850fadc09923329e, 0x03e2cf6bc604ddb0}, {0xa6539930bf6bff45, 0x84db8346b786151c},
+	{0xcfe87f7cef46ff16, 0xe612641865679a63}, {0x81f14fae158c5f6e, 0x4fcb7e8f3f60c07e},
+	{0xa26da3999aef7749, 0xe3be5e330f38f09d}, {0xcb090c8001ab551c, 0x5cadf5bfd3072cc5},
+	{0xfdcb4fa002162a63, 0x73d9732fc7c8f7f6}, {0x9e9f11c4014dda7e, 0x2867e7fddcdd9afa},
+	{0xc646d63501a1511d, 0xb281e1fd541501b8}, {0xf7d88bc24209a565, 0x1f225a7ca91a4226},
+	{0x9ae757596946075f, 0x3375788de9b06958}, {0xc1a12d2fc3978937, 0x0052d6b1641c83ae},
+	{0xf209787bb47d6b84, 0xc0678c5dbd23a49a}, {0x9745eb4d50ce6332, 0xf840b7ba963646e0},
+	{0xbd176620a501fbff, 0xb650e5a93bc3d898}, {0xec5d3fa8ce427aff, 0xa3e51f138ab4cebe},
+	{0x93ba47c980e98cdf, 0xc66f336c36b10137}, {0xb8a8d9bbe123f017, 0xb80b0047445d4184},
+	{0xe6d3102ad96cec1d, 0xa60dc059157491e5}, {0x9043ea1ac7e41392, 0x87c89837ad68db2f},
+	{0xb454e4a179dd1877, 0x29babe4598c311fb}, {0xe16a1dc9d8545e94, 0xf4296dd6fef3d67a},
+	{0x8ce2529e2734bb1d, 0x1899e4a65f58660c}, {0xb01ae745b101e9e4, 0x5ec05dcff72e7f8f},
+	{0xdc21a1171d42645d, 0x76707543f4fa1f73}, {0x899504ae72497eba, 0x6a06494a791c53a8},
+	{0xabfa45da0edbde69, 0x0487db9d17636892}, {0xd6f8d7509292d603, 0x45a9d2845d3c42b6},
+	{0x865b86925b9bc5c2, 0x0b8a2392ba45a9b2}, {0xa7f26836f282b732, 0x8e6cac7768d7141e},
+	{0xd1ef0244af2364ff, 0x3207d795430cd926}, {0x8335616aed761f1f, 0x7f44e6bd49e807b8},
+	{0xa402b9c5a8d3a6e7, 0x5f16206c9c6209a6}, {0xcd036837130890a1, 0x36dba887c37a8c0f},
+	{0x802221226be55a64, 0xc2494954da2c9789}, {0xa02aa96b06deb0fd, 0xf2db9baa10b7bd6c},
+	{0xc83553c5c8965d3d, 0x6f92829494e5acc7}, {0xfa42a8b73abbf48c, 0xcb772339ba1f17f9},
+	{0x9c69a97284b578d7, 0xff2a760414536efb}, {0xc38413cf25e2d70d, 0xfef5138519684aba},
+	{0xf46518c2ef5b8cd1, 0x7eb258665fc25d69}, {0x98bf2f79d5993802, 0xef2f773ffbd97a61},
+	{0xbeeefb584aff8603, 0xaafb550ffacfd8fa}, {0xeeaaba2e5dbf6784, 0x95ba2a53f983cf38},
+	{0x952ab45cfa97a0b2, 0xdd945a747bf26183}, {0xba756174393d88df, 0x94f971119aeef9e4},
+	{0xe912b9d1478ceb17, 0x7a37cd5601aab85d}, {0x91abb422ccb812ee, 0xac62e055c10ab33a},
+	{0xb616a12b7fe617aa, 0x577b986b314d6009}, {0xe39c49765fdf9d94, 0xed5a7e85fda0b80b},
+	{0x8e41ade9fbebc27d, 0x14588f13be847307}, {0xb1d219647ae6b31c, 0x596eb2d8ae258fc8},
+	{0xde469fbd99a05fe3, 0x6fca5f8ed9aef3bb}, {0x8aec23d680043bee, 0x25de7bb9480d5854},
+	{0xada72ccc20054ae9, 0xaf561aa79a10ae6a}, {0xd910f7ff28069da4, 0x1b2ba1518094da04},
+	{0x87aa9aff79042286, 0x90fb44d2f05d0842}, {0xa99541bf57452b28, 0x353a1607ac744a53},
+	{0xd3fa922f2d1675f2, 0x42889b8997915ce8}, {0x847c9b5d7c2e09b7, 0x69956135febada11},
+	{0xa59bc234db398c25, 0x43fab9837e699095}, {0xcf02b2c21207ef2e, 0x94f967e45e03f4bb},
+	{0x8161afb94b44f57d, 0x1d1be0eebac278f5}, {0xa1ba1ba79e1632dc, 0x6462d92a69731732},
+	{0xca28a291859bbf93, 0x7d7b8f7503cfdcfe}, {0xfcb2cb35e702af78, 0x5cda735244c3d43e},
+	{0x9defbf01b061adab, 0x3a0888136afa64a7}, {0xc56baec21c7a1916, 0x088aaa1845b8fdd0},
+	{0xf6c69a72a3989f5b, 0x8aad549e57273d45}, {0x9a3c2087a63f6399, 0x36ac54e2f678864b},
+	{0xc0cb28a98fcf3c7f, 0x84576a1bb416a7dd}, {0xf0fdf2d3f3c30b9f, 0x656d44a2a11c51d5},
+	{0x969eb7c47859e743, 0x9f644ae5a4b1b325}, {0xbc4665b596706114, 0x873d5d9f0dde1fee},
+	{0xeb57ff22fc0c7959, 0xa90cb506d155a7ea}, {0x9316ff75dd87cbd8, 0x09a7f12442d588f2},
+	{0xb7dcbf5354e9bece, 0x0c11ed6d538aeb2f}, {0xe5d3ef282a242e81, 0x8f1668c8a86da5fa},
+	{0x8fa475791a569d10, 0xf96e017d694487bc}, {0xb38d92d760ec4455, 0x37c981dcc395a9ac},
+	{0xe070f78d3927556a, 0x85bbe253f47b1417}, {0x8c469ab843b89562, 0x93956d7478ccec8e},
+	{0xaf58416654a6babb, 0x387ac8d1970027b2}, {0xdb2e51bfe9d0696a, 0x06997b05fcc0319e},
+	{0x88fcf317f22241e2, 0x441fece3bdf81f03}, {0xab3c2fddeeaad25a, 0xd527e81cad7626c3},
+	{0xd60b3bd56a5586f1, 0x8a71e223d8d3b074}, {0x85c7056562757456, 0xf6872d5667844e49},
+	{0xa738c6bebb12d16c, 0xb428f8ac016561db}, {0xd106f86e69d785c7, 0xe13336d701beba52},
+	{0x82a45b450226b39c, 0xecc0024661173473}, {0xa34d721642b06084, 0x27f002d7f95d0190},
+	{0xcc20ce9bd35c78a5, 0x31ec038df7b441f4}, {0xff290242c83396ce, 0x7e67047175a15271},
+	{0x9f79a169bd203e41, 0x0f0062c6e984d386}, {0xc75809c42c684dd1, 0x52c07b78a3e60868},
+	{0xf92e0c3537826145, 0xa7709a56ccdf8a82}, {0x9bbcc7a142b17ccb, 0x88a66076400bb691},
+	{0xc2abf989935ddbfe, 0x6acff893d00ea435}, {0xf356f7ebf83552fe, 0x0583f6b8c4124d43},
+	{0x98165af37b2153de, 0xc3727a337a8b704a}, {0xbe1bf1b059e9a8d6, 0x744f18c0592e4c5c},
+	{0xeda2ee1c7064130c, 0x1162def06f79df73}, {0x9485d4d1c63e8be7, 0x8addcb5645ac2ba8},
+	{0xb9a74a0637ce2ee1, 0x6d953e2bd7173692}, {0xe8111c87c5c1ba99, 0xc8fa8db6ccdd0437},
+	{0x910ab1d4db9914a0, 0x1d9c9892400a22a2}, {0xb54d5e4a127f59c8, 0x2503beb6d00cab4b},
+	{0xe2a0b5dc971f303a, 0x2e44ae64840fd61d}, {0x8da471a9de737e24, 0x5ceaecfed289e5d2},
+	{0xb10d8e1456105dad, 0x7425a83e872c5f47}, {0xdd50f1996b947518, 0xd12f124e28f77719},
+	{0x8a5296ffe33cc92f, 0x82bd6b70d99aaa6f}, {0xace73cbfdc0bfb7b, 0x636cc64d1001550b},
+	{0xd8210befd30efa5a, 0x3c47f7e05401aa4e}, {0x8714a775e3e95c78, 0x65acfaec34810a71},
+	{0xa8d9d1535ce3b396, 0x7f1839a741a14d0d}, {0xd31045a8341ca07c, 0x1ede48111209a050},
+	{0x83ea2b892091e44d, 0x934aed0aab460432}, {0xa4e4b66b68b65d60, 0xf81da84d5617853f},
+	{0xce1de40642e3f4b9, 0x36251260ab9d668e}, {0x80d2ae83e9ce78f3, 0xc1d72b7c6b426019},
+	{0xa1075a24e4421730, 0xb24cf65b8612f81f}, {0xc94930ae1d529cfc, 0xdee033f26797b627},
+	{0xfb9b7cd9a4a7443c, 0x169840ef017da3b1}, {0x9d412e0806e88aa5, 0x8e1f289560ee864e},
+	{0xc491798a08a2ad4e, 0xf1a6f2bab92a27e2}, {0xf5b5d7ec8acb58a2, 0xae10af696774b1db},
+	{0x9991a6f3d6bf1765, 0xacca6da1e0a8ef29}, {0xbff610b0cc6edd3f, 0x17fd090a58d32af3},
+	{0xeff394dcff8a948e, 0xddfc4b4cef07f5b0}, {0x95f83d0a1fb69cd9, 0x4abdaf101564f98e},
+	{0xbb764c4ca7a4440f, 0x9d6d1ad41abe37f1}, {0xea53df5fd18d5513, 0x84c86189216dc5ed},
+	{0x92746b9be2f8552c, 0x32fd3cf5b4e49bb4}, {0xb7118682dbb66a77, 0x3fbc8c33221dc2a1},
+	{0xe4d5e82392a40515, 0x0fabaf3feaa5334a}, {0x8f05b1163ba6832d, 0x29cb4d87f2a7400e},
+	{0xb2c71d5bca9023f8, 0x743e20e9ef511012}, {0xdf78e4b2bd342cf6, 0x914da9246b255416},
+	{0x8bab8eefb6409c1a, 0x1ad089b6c2f7548e}, {0xae9672aba3d0c320, 0xa184ac2473b529b1},
+	{0xda3c0f568cc4f3e8, 0xc9e5d72d90a2741e}, {0x8865899617fb1871, 0x7e2fa67c7a658892},
+	{0xaa7eebfb9df9de8d, 0xddbb901b98feeab7}, {0xd51ea6fa85785631, 0x552a74227f3ea565},
+	{0x8533285c936b35de, 0xd53a88958f87275f}, {0xa67ff273b8460356, 0x8a892abaf368f137},
+	{0xd01fef10a657842c, 0x2d2b7569b0432d85}, {0x8213f56a67f6b29b, 0x9c3b29620e29fc73},
+	{0xa298f2c501f45f42, 0x8349f3ba91b47b8f}, {0xcb3f2f7642717713, 0x241c70a936219a73},
+	{0xfe0efb53d30dd4d7, 0xed238cd383aa0110}, {0x9ec95d1463e8a506, 0xf4363804324a40aa},
+	{0xc67bb4597ce2ce48, 0xb143c6053edcd0d5}, {0xf81aa16fdc1b81da, 0xdd94b7868e94050a},
+	{0x9b10a4e5e9913128, 0xca7cf2b4191c8326}, {0xc1d4ce1f63f57d72, 0xfd1c2f611f63a3f0},
+	{0xf24a01a73cf2dccf, 0xbc633b39673c8cec}, {0x976e41088617ca01, 0xd5be0503e085d813},
+	{0xbd49d14aa79dbc82, 0x4b2d8644d8a74e18}, {0xec9c459d51852ba2, 0xddf8e7d60ed1219e},
+	{0x93e1ab8252f33b45, 0xcabb90e5c942b503}, {0xb8da1662e7b00a17, 0x3d6a751f3b936243},
+	{0xe7109bfba19c0c9d, 0x0cc512670a783ad4}, {0x906a617d450187e2, 0x27fb2b80668b24c5},
+	{0xb484f9dc9641e9da, 0xb1f9f660802dedf6}, {0xe1a63853bbd26451, 0x5e7873f8a0396973},
+	{0x8d07e33455637eb2, 0xdb0b487b6423e1e8}, {0xb049dc016abc5e5f, 0x91ce1a9a3d2cda62},
+	{0xdc5c5301c56b75f7, 0x7641a140cc7810fb}, {0x89b9b3e11b6329ba, 0xa9e904c87fcb0a9d},
+	{0xac2820d9623bf429, 0x546345fa9fbdcd44}, {0xd732290fbacaf133, 0xa97c177947ad4095},
+	{0x867f59a9d4bed6c0, 0x49ed8eabcccc485d}, {0xa81f301449ee8c70, 0x5c68f256bfff5a74},
+	{0xd226fc195c6a2f8c, 0x73832eec6fff3111}, {0x83585d8fd9c25db7, 0xc831fd53c5ff7eab},
+	{0xa42e74f3d032f525, 0xba3e7ca8b77f5e55}, {0xcd3a1230c43fb26f, 0x28ce1bd2e55f35eb},
+	{0x80444b5e7aa7cf85, 0x7980d163cf5b81b3}, {0xa0555e361951c366, 0xd7e105bcc332621f},
+	{0xc86ab5c39fa63440, 0x8dd9472bf3fefaa7}, {0xfa856334878fc150, 0xb14f98f6f0feb951},
+	{0x9c935e00d4b9d8d2, 0x6ed1bf9a569f33d3}, {0xc3b8358109e84f07, 0x0a862f80ec4700c8},
+	{0xf4a642e14c6262c8, 0xcd27bb612758c0fa}, {0x98e7e9cccfbd7dbd, 0x8038d51cb897789c},
+	{0xbf21e44003acdd2c, 0xe0470a63e6bd56c3}, {0xeeea5d5004981478, 0x1858ccfce06cac74},
+	{0x95527a5202df0ccb, 0x0f37801e0c43ebc8}, {0xbaa718e68396cffd, 0xd30560258f54e6ba},
+	{0xe950df20247c83fd, 0x47c6b82ef32a2069}, {0x91d28b7416cdd27e, 0x4cdc331d57fa5441},
+	{0xb6472e511c81471d, 0xe0133fe4adf8e952}, {0xe3d8f9e563a198e5, 0x58180fddd97723a6},
+	{0x8e679c2f5e44ff8f, 0x570f09eaa7ea7648}
+};
+
+// Powers of ten that are exactly representable as a double
+static const double json_pow10_exact[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+										  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Multiplies a and b and returns the low 64 bits of the product, and writes the high 64 bits to hi
+static uint64_t json_mul128(uint64_t a, uint64_t b, uint64_t* hi)
+{
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 r = (unsigned __int128)a * b;
+	*hi = (uint64_t)(r >> 64);
+	return (uint64_t)r;
+#else
+	uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+	uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+	uint64_t lo_lo = a_lo * b_lo;
+	uint64_t hi_lo = a_hi * b_lo;
+	uint64_t lo_hi = a_lo * b_hi;
+	uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+	*hi = a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+	return (cross << 32) | (uint32_t)lo_lo;
+#endif
+}
+
+// Returns the number of leading zero bits of a non zero x
+static int json_clz64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_clzll(x);
+#else
+	int n = 0;
+	for (; !(x & 0x8000000000000000ull); x <<= 1)
+		n++;
+	return n;
+#endif
+}
+
+// Converts w * 10^q to the nearest double with the Eisel-Lemire algorithm
+// Returns 0 if the result can't be rounded correctly this way, which is very rare
+static int json_eisel_lemire(uint64_t w, int q, double* out)
+{
+	if (w == 0 || q < JSON_POW10_MIN)
+	{
+		*out = 0;
+		return 1;
+	}
+	if (q > JSON_POW10_MAX)
+	{
+		*out = HUGE_VAL;
+		return 1;
+	}
+
+	// Normalize w and multiply it by the truncated 5^q
+	// 55 bits are needed for the 52 bit mantissa, the implicit bit, the rounding bit, and the possibly unset top bit
+	int lz = json_clz64(w);
+	w <<= lz;
+	const uint64_t* pow5 = json_pow5_128[q - JSON_POW10_MIN];
+	uint64_t hi;
+	uint64_t lo = json_mul128(w, pow5[0], &hi);
+	if ((hi & 0x1FF) == 0x1FF)
+	{
+		// The lower bits could carry into the upper 55, refine with the next 64 bits of 5^q
+		uint64_t hi2;
+		json_mul128(w, pow5[1], &hi2);
+		lo += hi2;
+		if (hi2 > lo)
+			hi++;
+	}
+	// The product is exact for these q, otherwise the truncation of 5^q could have changed the result
+	if (lo == UINT64_MAX && (q < -27 || q > 55))
+		return 0;
+
+	int upperbit = (int)(hi >> 63);
+	uint64_t mantissa = hi >> (upperbit + 9);
+	// floor(log2(10^q)) + 63, and the exponent bias
+	int power2 = (int)(((152170 + 65536) * (int64_t)q) >> 16) + 63 + upperbit - lz + 1023;
+
+	// Subnormal
+	if (power2 <= 0)
+	{
+		if (-power2 + 1 >= 64)
+		{
+			*out = 0;
+			return 1;
+		}
+		mantissa >>= -power2 + 1;
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		// Rounding up can make the number normal
+		power2 = mantissa < (1ull << 52) ? 0 : 1;
+	}
+	else
+	{
+		// Exactly halfway between two doubles, which is only possible for small q, round to even instead of up
+		if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << (upperbit + 9)) == hi)
+			mantissa &= ~(uint64_t)1;
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		if (mantissa >= (2ull << 52))
+		{
+			mantissa = 1ull << 52;
+			power2++;
+		}
+		mantissa &= ~(1ull << 52);
+		if (power2 >= 0x7FF)
+		{
+			*out = HUGE_VAL;
+			return 1;
+		}
+	}
+
+	uint64_t bits = mantissa | (uint64_t)power2 << 52;
+	memcpy(out, &bits, sizeof *out);
+	return 1;
+}
+
+// Converts the number in [str, end) with strtod, when the mantissa and exponent don't determine the double
+static double json_strtod(const char* str, const char* end)
+{
+	char buf[128];
+	size_t len = end - str;
+	char* tmp = len < sizeof buf ? buf : JSON_MALLOC(len + 1);
+	memcpy(tmp, str, len);
+	tmp[len] = '\0';
+	// strtod expects the decimal point of the current locale
+	char point = localeconv()->decimal_point[0];
+	if (point != '.')
+	{
+		char* p = memchr(tmp, '.', len);
+		if (p)
+			*p = point;
+	}
+	double result = strtod(tmp, NULL);
+	if (tmp != buf)
+		JSON_FREE(tmp);
+	return result;
+}
+
+// A number read by json_read_number
+struct JSONNumber
+{
+	// Set if the number is an integer that fits exactly in intval
+	int integer;
+	union
+	{
+		double numval;
+		int64_t intval;
+	} val;
+};
+
+// Reads a json number from str
+// Integers that fit in 64 bits are read exactly, other numbers are rounded to the nearest double
+// Reads no further than end
+// Returns a pointer to the character after the number, or NULL if it's not a valid number
+static char* json_read_number(char* str, char* end, struct JSONNumber* out)
+{
+	char* start = str;
+	int negative = 0;
+	if (str < end && *str == '-')
+	{
+		negative = 1;
+		str++;
+	}
+
+	// The first 19 significant digits, which always fit in 64 bits
+	uint64_t mantissa = 0;
+	int digits = 0;
+	// The power of ten to scale the mantissa by
+	int exponent = 0;
+	// Set if non zero digits after the first 19 were dropped
+	int truncated = 0;
+	int integer = 1;
+
+	if (str == end || *str < '0' || *str > '9')
+		return NULL;
+
+	// Integer part, no leading zeros are allowed
+	if (*str == '0')
+		str++;
+	else
+	{
+		for (; str < end && *str >= '0' && *str <= '9'; str++)
+		{
+			if (digits < 19)
+			{
+				mantissa = mantissa * 10 + (*str - '0');
+				digits++;
+			}
+			else
+			{
+				exponent++;
+				truncated |= *str != '0';
+			}
+		}
+	}
+
+	// Fraction
+	if (str < end && *str == '.')
+	{
+		integer = 0;
+		str++;
+		char* first = str;
+		for (; str < end && *str >= '0' && *str <= '9'; str++)
+		{
+			if (digits < 19)
+			{
+				mantissa = mantissa * 10 + (*str - '0');
+				exponent--;
+				// Leading zeros of the fraction aren't significant
+				if (mantissa)
+					digits++;
+			}
+			else
+				truncated |= *str != '0';
+		}
+		if (str == first)
+			return NULL;
+	}
+
+	// Exponent
+	if (str < end && (*str == 'e' || *str == 'E'))
+	{
+		integer = 0;
+		str++;
+		int exp_negative = 0;
+		if (str < end && (*str == '-' || *str == '+'))
+			exp_negative = *str++ == '-';
+		char* first = str;
+		int value = 0;
+		for (; str < end && *str >= '0' && *str <= '9'; str++)
+		{
+			// Anything larger rounds to zero or infinity anyway
+			if (value < 100000)
+				value = value * 10 + (*str - '0');
+		}
+		if (str == first)
+			return NULL;
+		exponent += exp_negative ? -value : value;
+	}
+
+	// Integers are kept exact if they fit, except -0 which is only a double
+	out->integer =
+		integer && exponent == 0 && (negative ? mantissa - 1 <= (uint64_t)INT64_MAX : mantissa <= (uint64_t)INT64_MAX);
+	if (out->integer)
+	{
+		out->val.intval = negative ? (int64_t)(0 - mantissa) : (int64_t)mantissa;
+		return str;
+	}
+
+	double result;
+	// Both the mantissa and the power of ten are exact doubles, so a single multiplication or division is correctly
+	// rounded
+	if (!truncated && mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22)
+	{
+		result = (double)mantissa;
+		result = exponent < 0 ? result / json_pow10_exact[-exponent] : result * json_pow10_exact[exponent];
+	}
+	else
+	{
+		// If digits were dropped, the number lies between mantissa and mantissa + 1, and is only determined if both
+		// round to the same double
+		double upper;
+		if (!json_eisel_lemire(mantissa, exponent, &result) ||
+			(truncated && (!json_eisel_lemire(mantissa + 1, exponent, &upper) || upper != result)))
+			result = json_strtod(start + negative, str);
+	}
+
+	out->val.numval = negative ? -result : result;
+	return str;
+}
+
+// A floating point number f * 2^e with a 64 bit significand, used by the Grisu2 number formatting
+struct JSONDiyFp
+{
+	uint64_t f;
+	int e;
+};
+
+// Normalized powers of ten 10^k = f * 2^e, for every eighth k
+struct JSONCachedPower
+{
+	uint64_t f;
+	int e;
+	int k;
+};
+
+static const struct JSONCachedPower json_cached_powers[] = {
+	{0xAB70FE17C79AC6CA, -1060, -300},
+	{0xFF77B1FCBEBCDC4F, -1034, -292},
+	{0xBE5691EF416BD60C, -1007, -284},
+	{0x8DD01FAD907FFC3C, -980, -276},
+	{0xD3515C2831559A83, -954, -268},
+	{0x9D71AC8FADA6C9B5, -927, -260},
+	{0xEA9C227723EE8BCB, -901, -252},
+	{0xAECC49914078536D, -874, -244},
+	{0x823C12795DB6CE57, -847, -236},
+	{0xC21094364DFB5637, -821, -228},
+	{0x9096EA6F3848984F, -794, -220},
+	{0xD77485CB25823AC7, -768, -212},
+	{0xA086CFCD97BF97F4, -741, -204},
+	{0xEF340A98172AACE5, -715, -196},
+	{0xB23867FB2A35B28E, -688, -188},
+	{0x84C8D4DFD2C63F3B, -661, -180},
+	{0xC5DD44271AD3CDBA, -635, -172},
+	{0x936B9FCEBB25C996, -608, -164},
+	{0xDBAC6C247D62A584, -582, -156},
+	{0xA3AB66580D5FDAF6, -555, -148},
+	{0xF3E2F893DEC3F126, -529, -140},
+	{0xB5B5ADA8AAFF80B8, -502, -132},
+	{0x87625F056C7C4A8B, -475, -124},
+	{0xC9BCFF6034C13053, -449, -116},
+	{0x964E858C91BA2655, -422, -108},
+	{0xDFF9772470297EBD, -396, -100},
+	{0xA6DFBD9FB8E5B88F, -369, -92},
+	{0xF8A95FCF88747D94, -343, -84},
+	{0xB94470938FA89BCF, -316, -76},
+	{0x8A08F0F8BF0F156B, -289, -68},
+	{0xCDB02555653131B6, -263, -60},
+	{0x993FE2C6D07B7FAC, -236, -52},
+	{0xE45C10C42A2B3B06, -210, -44},
+	{0xAA242499697392D3, -183, -36},
+	{0xFD87B5F28300CA0E, -157, -28},
+	{0xBCE5086492111AEB, -130, -20},
+	{0x8CBCCC096F5088CC, -103, -12},
+	{0xD1B71758E219652C, -77, -4},
+	{0x9C40000000000000, -50, 4},
+	{0xE8D4A51000000000, -24, 12},
+	{0xAD78EBC5AC620000, 3, 20},
+	{0x813F3978F8940984, 30, 28},
+	{0xC097CE7BC90715B3, 56, 36},
+	{0x8F7E32CE7BEA5C70, 83, 44},
+	{0xD5D238A4ABE98068, 109, 52},
+	{0x9F4F2726179A2245, 136, 60},
+	{0xED63A231D4C4FB27, 162, 68},
+	{0xB0DE65388CC8ADA8, 189, 76},
+	{0x83C7088E1AAB65DB, 216, 84},
+	{0xC45D1DF942711D9A, 242, 92},
+	{0x924D692CA61BE758, 269, 100},
+	{0xDA01EE641A708DEA, 295, 108},
+	{0xA26DA3999AEF774A, 322, 116},
+	{0xF209787BB47D6B85, 348, 124},
+	{0xB454E4A179DD1877, 375, 132},
+	{0x865B86925B9BC5C2, 402, 140},
+	{0xC83553C5C8965D3D, 428, 148},
+	{0x952AB45CFA97A0B3, 455, 156},
+	{0xDE469FBD99A05FE3, 481, 164},
+	{0xA59BC234DB398C25, 508, 172},
+	{0xF6C69A72A3989F5C, 534, 180},
+	{0xB7DCBF5354E9BECE, 561, 188},
+	{0x88FCF317F22241E2, 588, 196},
+	{0xCC20CE9BD35C78A5, 614, 204},
+	{0x98165AF37B2153DF, 641, 212},
+	{0xE2A0B5DC971F303A, 667, 220},
+	{0xA8D9D1535CE3B396, 694, 228},
+	{0xFB9B7CD9A4A7443C, 720, 236},
+	{0xBB764C4CA7A44410, 747, 244},
+	{0x8BAB8EEFB6409C1A, 774, 252},
+	{0xD01FEF10A657842C, 800, 260},
+	{0x9B10A4E5E9913129, 827, 268},
+	{0xE7109BFBA19C0C9D, 853, 276},
+	{0xAC2820D9623BF429, 880, 284},
+	{0x80444B5E7AA7CF85, 907, 292},
+	{0xBF21E44003ACDD2D, 933, 300},
+	{0x8E679C2F5E44FF8F, 960, 308},
+	{0xD433179D9C8CB841, 986, 316},
+	{0x9E19DB92B4E31BA9, 1013, 324}
+};
+
+// Multiplies two numbers and rounds the product to 64 bits
+static struct JSONDiyFp json_diyfp_mul(struct JSONDiyFp x, struct JSONDiyFp y)
+{
+	uint64_t hi;
+	uint64_t lo = json_mul128(x.f, y.f, &hi);
+	struct JSONDiyFp result = {hi + (lo >> 63), x.e + y.e + 64};
+	return result;
+}
+
+static struct JSONDiyFp json_diyfp_normalize(struct JSONDiyFp x)
+{
+	int lz = json_clz64(x.f);
+	x.f <<= lz;
+	x.e -= lz;
+	return x;
+}
+
+// Trims the last digit towards w while it stays within the rounding interval
+static void json_grisu2_round(char* buf, int len, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t ten_k)
+{
+	while (rest < dist && delta - rest >= ten_k && (rest + ten_k < dist || dist - rest > rest + ten_k - dist))
+	{
+		buf[len - 1]--;
+		rest += ten_k;
+	}
+}
+
+// Generates the shortest digits of w that lie within (low, high), which are scaled to an exponent in [-60, -32]
+// Returns the number of digits written to buf, and adds the power of ten of the last digit to exponent
+static int json_grisu2_digits(char* buf, int* exponent, struct JSONDiyFp low, struct JSONDiyFp w, struct JSONDiyFp high)
+{
+	uint64_t delta = high.f - low.f;
+	uint64_t dist = high.f - w.f;
+	int shift = -high.e;
+	uint64_t one = (uint64_t)1 << shift;
+	// The integral and fractional parts of high
+	uint32_t p1 = (uint32_t)(high.f >> shift);
+	uint64_t p2 = high.f & (one - 1);
+
+	int n = 10;
+	uint32_t pow10 = 1000000000;
+	while (n > 1 && p1 < pow10)
+	{
+		pow10 /= 10;
+		n--;
+	}
+
+	int len = 0;
+	while (n > 0)
+	{
+		buf[len++] = '0' + p1 / pow10;
+		p1 %= pow10;
+		n--;
+		uint64_t rest = ((uint64_t)p1 << shift) + p2;
+		if (rest <= delta)
+		{
+			*exponent += n;
+			json_grisu2_round(buf, len, dist, delta, rest, (uint64_t)pow10 << shift);
+			return len;
+		}
+		pow10 /= 10;
+	}
+
+	for (;;)
+	{
+		p2 *= 10;
+		buf[len++] = '0' + (p2 >> shift);
+		p2 &= one - 1;
+		delta *= 10;
+		dist *= 10;
+		(*exponent)--;
+		if (p2 <= delta)
+			break;
+	}
+	json_grisu2_round(buf, len, dist, delta, p2, one);
+	return len;
+}
+
+// Writes the shortest digits that round trip to a positive finite num with the Grisu2 algorithm by Florian Loitsch
+// The digits are almost always the shortest possible, and always read back as exactly num
+// Returns the number of digits, the value is digits * 10^exponent
+static int json_grisu2(double num, char* buf, int* exponent)
+{
+	uint64_t bits;
+	memcpy(&bits, &num, sizeof bits);
+	uint64_t F = bits & ((1ull << 52) - 1);
+	int E = (int)(bits >> 52);
+
+	struct JSONDiyFp v;
+	if (E == 0)
+	{
+		v.f = F;
+		v.e = 1 - 1075;
+	}
+	else
+	{
+		v.f = F | (1ull << 52);
+		v.e = E - 1075;
+	}
+
+	// The boundaries halfway to the neighbouring doubles, the lower is closer when at a power of two
+	struct JSONDiyFp high = {2 * v.f + 1, v.e - 1};
+	struct JSONDiyFp low = (F == 0 && E > 1) ? (struct JSONDiyFp){4 * v.f - 1, v.e - 2}
+											 : (struct JSONDiyFp){2 * v.f - 1, v.e - 1};
+	high = json_diyfp_normalize(high);
+	low.f <<= low.e - high.e;
+	low.e = high.e;
+	v = json_diyfp_normalize(v);
+
+	// Find a power of ten that brings the exponent of high into [-60, -32]
+	int f = -60 - high.e - 1;
+	int k = (f * 78913) / (1 << 18) + (f > 0);
+	const struct JSONCachedPower* cached = &json_cached_powers[(300 + k + 7) / 8];
+	struct JSONDiyFp c = {cached->f, cached->e};
+
+	struct JSONDiyFp w = json_diyfp_mul(v, c);
+	low = json_diyfp_mul(low, c);
+	high = json_diyfp_mul(high, c);
+	// Shrink the interval by one unit to stay inside the bounds despite rounding in the multiplication
+	low.f++;
+	high.f--;
+
+	*exponent = -cached->k;
+	return json_grisu2_digits(buf, exponent, low, w, high);
+}
+
+static const char json_digit_pairs[] = "0001020304050607080910111213141516171819"
+										"2021222324252627282930313233343536373839"
+										"4041424344454647484950515253545556575859"
+										"6061626364656667686970717273747576777879"
+										"8081828384858687888990919293949596979899";
+
+// Writes an unsigned integer and returns how many characters were written
+static int json_utoa(uint64_t num, char* buf)
+{
+	int len = 1;
+	for (uint64_t n = num; n >= 10; n /= 10)
+		len++;
+
+	// Write two digits at a time from the end
+	char* p = buf + len;
+	*p = '\0';
+	while (num >= 100)
+	{
+		p -= 2;
+		memcpy(p, json_digit_pairs + num % 100 * 2, 2);
+		num /= 100;
+	}
+	if (num >= 10)
+		memcpy(p - 2, json_digit_pairs + num * 2, 2);
+	else
+		p[-1] = '0' + num;
+	return len;
+}
+
+// Writes a signed integer and returns how many characters were written
+static int json_itoa(int64_t num, char* buf)
+{
+	if (num < 0)
+	{
+		*buf = '-';
+		return json_utoa(0 - (uint64_t)num, buf + 1) + 1;
+	}
+	return json_utoa(num, buf);
+}
+
+// Converts a double to the shortest string that reads back as the same double
+// Integral values are written without fraction or exponent, others as decimals or in scientific notation when
+// very large or small. Infinity and NaN aren't valid json and are written as null
+// buf needs room for at least 32 characters
+// Returns how many characters were written
+static int json_dtoa(double num, char* buf)
+{
+	if (!isfinite(num))
+	{
+		memcpy(buf, "null", 5);
+		return 4;
+	}
+
+	char* start = buf;
+	if (signbit(num))
+	{
+		*buf++ = '-';
+		num = -num;
+	}
+	if (num == 0)
+	{
+		*buf++ = '0';
+		*buf = '\0';
+		return buf - start;
+	}
+	// Integer fast path
+	if (num < 9007199254740992.0 && num == (double)(uint64_t)num)
+		return buf - start + json_utoa((uint64_t)num, buf);
+
+	int exponent;
+	int len = json_grisu2(num, buf, &exponent);
+	// The value is buf * 10^exponent, with the decimal point point places into the digits
+	int point = len + exponent;
+
+	// Integer with trailing zeros
+	if (exponent >= 0 && point <= 21)
+	{
+		memset(buf + len, '0', exponent);
+		buf += point;
+	}
+	// Decimal point inside the digits
+	else if (point > 0 && point <= 21)
+	{
+		memmove(buf + point + 1, buf + point, len - point);
+		buf[point] = '.';
+		buf += len + 1;
+	}
+	// Small number with leading zeros
+	else if (point > -6 && point <= 0)
+	{
+		memmove(buf + 2 - point, buf, len);
+		buf[0] = '0';
+		buf[1] = '.';
+		memset(buf + 2, '0', -point);
+		buf += 2 - point + len;
+	}
+	// Scientific notation
+	else
+	{
+		if (len > 1)
+		{
+			memmove(buf + 2, buf + 1, len - 1);
+			buf[1] = '.';
+			buf += len + 1;
+		}
+		else
+			buf++;
+		*buf++ = 'e';
+		buf += json_itoa(point - 1, buf);
+	}
+	*buf = '\0';
+	return buf - start;
+}
+
+// Reads the four hex digits at str
+// Returns their value, or -1 if one isn't a hex digit
+static long json_hex4(const char* str)
+{
+	long value = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		char c = str[i];
+		int digit;
+		if (c >= '0' && c <= '9')
+			digit = c - '0';
+		else if (c >= 'a' && c <= 'f')
+			digit = c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F')
+			digit = c - 'A' + 10;
+		else
+			return -1;
+		value = value << 4 | digit;
+	}
+	return value;
+}
+
+// Decodes the escape sequence \uXXXX at str into UTF-8 at out, together with the one that follows for a surrogate pair
+// *written is set to the number of bytes written to out, which is never more than the escape sequences are long
+// Returns the length of the escape sequences, 0 if they are invalid, or -1 if end cuts them off
+static int json_unescape_unicode(const char* str, const char* end, char* out, int* written)
+{
+	if (end - str < 6)
+		return -1;
+	long code = json_hex4(str + 2);
+	if (code < 0 || (code >= 0xDC00 && code <= 0xDFFF))
+		return 0;
+	int len = 6;
+	if (code >= 0xD800 && code <= 0xDBFF)
+	{
+		// The high surrogate needs the low surrogate after it
+		if (end - str < 12)
+			return end - str > 6 && str[6] != '\\' ? 0 : -1;
+		long low = str[6] == '\\' && str[7] == 'u' ? json_hex4(str + 8) : -1;
+		if (low < 0xDC00 || low > 0xDFFF)
+			return 0;
+		code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+		len = 12;
+	}
+
+	unsigned char* p = (unsigned char*)out;
+	if (code < 0x80)
+		*p++ = (unsigned char)code;
+	else if (code < 0x800)
+	{
+		*p++ = 0xC0 | code >> 6;
+		*p++ = 0x80 | (code & 0x3F);
+	}
+	else if (code < 0x10000)
+	{
+		*p++ = 0xE0 | code >> 12;
+		*p++ = 0x80 | (code >> 6 & 0x3F);
+		*p++ = 0x80 | (code & 0x3F);
+	}
+	else
+	{
+		*p++ = 0xF0 | code >> 18;
+		*p++ = 0x80 | (code >> 12 & 0x3F);
+		*p++ = 0x80 | (code >> 6 & 0x3F);
+		*p++ = 0x80 | (code & 0x3F);
+	}
+	*written = (int)(p - (unsigned char*)out);
+	return len;
+}
+
+#ifdef JSON_VALIDATE_UTF8
+// Returns the first character from str that isn't part of valid UTF-8, or NULL if the string up to end is valid
+// ASCII is skipped 16 characters at a time with SSE2, or 8 at a time within words otherwise
+static const char* json_utf8_invalid(const char* str, const char* end)
+{
+	while (str < end)
+	{
+#if JSON_SSE2
+		while (end - str >= 16 && !_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)str)))
+			str += 16;
+#else
+		for (uint64_t word; end - str >= 8; str += 8)
+		{
+			memcpy(&word, str, sizeof word);
+			if (word & 0x8080808080808080ull)
+				break;
+		}
+#endif
+		if (str == end)
+			break;
+		uint32_t code;
+		int len = json_utf8_decode((const unsigned char*)str, (const unsigned char*)end, &code);
+		if (len == 0)
+			return str;
+		str += len;
+	}
+	return NULL;
+}
+#endif
+
+// Returns the character of the escape sequence \c, or -1 if it's not a valid escape sequence
+static int json_unescape(char c)
+{
+	switch (c)
+	{
+	case '"':
+		return '"';
+	case '\\':
+		return '\\';
+	case '/':
+		return '/';
+	case 'b':
+		return '\b';
+	case 'f':
+		return '\f';
+	case 'n':
+		return '\n';
+	case 'r':
+		return '\r';
+	case 't':
+		return '\t';
+	default:
+		return -1;
+	}
+}
+
+// Blocks are only classified with SSE2 or AVX2, without them the scans are faster with memchr than within words
+#if JSON_SSE2
+// The structural characters of a block of 64 characters, one bit per character
+struct JSONBlockMasks
+{
+	uint64_t quote;
+	uint64_t backslash;
+	// '{' and '['
+	uint64_t open;
+	// '}' and ']'
+	uint64_t close;
+	uint64_t comma;
+};
+
+// Returns the number of bits set in x
+static int json_popcount64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountll(x);
+#else
+	x -= x >> 1 & 0x5555555555555555ull;
+	x = (x & 0x3333333333333333ull) + (x >> 2 & 0x3333333333333333ull);
+	x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+	return (int)(x * 0x0101010101010101ull >> 56);
+#endif
+}
+
+// Compares 16 characters at a time
+static void json_classify_sse2(const char* block, struct JSONBlockMasks* m)
+{
+	uint64_t quote = 0, backslash = 0, open = 0, close = 0, comma = 0;
+	for (int i = 0; i < 64; i += 16)
+	{
+		__m128i c = _mm_loadu_si128((const __m128i*)(block + i));
+		// '[' and ']' become '{' and '}' with the 0x20 bit set
+		__m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+		quote |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8('"'))) << i;
+		backslash |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8('\\'))) << i;
+		open |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{'))) << i;
+		close |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(lower, _mm_set1_epi8('}'))) << i;
+		comma |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8(','))) << i;
+	}
+	*m = (struct JSONBlockMasks){quote, backslash, open, close, comma};
+}
+
+#if JSON_AVX2
+// Compares 32 characters at a time, only called when the processor supports it
+__attribute__((target("avx2"))) static void json_classify_avx2(const char* block, struct JSONBlockMasks* m)
+{
+	uint64_t quote = 0, backslash = 0, open = 0, close = 0, comma = 0;
+	for (int i = 0; i < 64; i += 32)
+	{
+		__m256i c = _mm256_loadu_si256((const __m256i*)(block + i));
+		__m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+		quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('"'))) << i;
+		backslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('\\'))) << i;
+		open |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{'))) << i;
+		close |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}'))) << i;
+		comma |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, _mm256_set1_epi8(','))) << i;
+	}
+	*m = (struct JSONBlockMasks){quote, backslash, open, close, comma};
+}
+#endif
+
+// Returns a mask where each bit is the xor of all bits of x up to and including it
+static uint64_t json_prefix_xor(uint64_t x)
+{
+	x ^= x << 1;
+	x ^= x << 2;
+	x ^= x << 4;
+	x ^= x << 8;
+	x ^= x << 16;
+	x ^= x << 32;
+	return x;
+}
+
+// Follows strings through a document a block of 64 characters at a time
+struct JSONScanner
+{
+	void (*classify)(const char* block, struct JSONBlockMasks* m);
+	// Set if the first character of the next block is escaped
+	uint64_t escaped;
+	// All bits set if the next block starts inside a string
+	uint64_t in_string;
+};
+
+// Starts scanning inside a string if in_string is set, with the first character escaped if escaped is set
+// The fastest classification the processor supports is chosen
+static void json_scanner_init(struct JSONScanner* s, int in_string, int escaped)
+{
+	s->classify = json_classify_sse2;
+#if JSON_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		s->classify = json_classify_avx2;
+#endif
+	s->escaped = escaped ? 1 : 0;
+	s->in_string = in_string ? ~(uint64_t)0 : 0;
+}
+
+// Classifies the block of 64 characters from str, or up to end if it's closer, and keeps the quotes that start or end
+// strings and the brackets and commas outside of them
+static void json_scanner_next(struct JSONScanner* s, const char* str, const char* end, struct JSONBlockMasks* m)
+{
+	if (end - str >= 64)
+		s->classify(str, m);
+	else
+	{
+		// The last block is padded with whitespace
+		char block[64];
+		memset(block, ' ', sizeof block);
+		memcpy(block, str, end - str);
+		s->classify(block, m);
+	}
+
+	// Characters after a backslash that isn't itself escaped
+	uint64_t escaped = s->escaped;
+	uint64_t backslash = m->backslash & ~escaped;
+	s->escaped = 0;
+	while (backslash)
+	{
+		int i = json_ctz64(backslash);
+		backslash &= backslash - 1;
+		if (escaped >> i & 1)
+			continue;
+		if (i == 63)
+			s->escaped = 1;
+		else
+			escaped |= 2ull << i;
+	}
+
+	// Start quotes are inside strings, end quotes outside
+	m->quote &= ~escaped;
+	uint64_t in_string = json_prefix_xor(m->quote) ^ s->in_string;
+	s->in_string = (uint64_t)0 - (in_string >> 63);
+	m->open &= ~in_string;
+	m->close &= ~in_string;
+	m->comma &= ~in_string;
+}
+
+// Skips whitespace 16 characters at a time, leaving the last few before end to the caller
+static char* json_skip_whitespace(char* str, char* end)
+{
+	while (end - str >= 16)
+	{
+		__m128i c = _mm_loadu_si128((const __m128i*)str);
+		__m128i spaces = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(c, _mm_set1_epi8('\t'))),
+			_mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(c, _mm_set1_epi8('\r'))));
+		unsigned other = ~_mm_movemask_epi8(spaces) & 0xFFFF;
+		if (other)
+			return str + json_ctz64(other);
+		str += 16;
+	}
+	return str;
+}
+#endif
+
+// The state of parsing a string with the events passed to a handler
+struct JSONParser
+{
+	const JSONHandler* handler;
+	void* ctx;
+	// The end of the parsed string, nothing at or after end is read
+	char* end;
+	// Strings and names are unescaped in place and zero terminated instead of copied to scratch
+	int insitu;
+	// Holds strings with escape sequences until they're passed to the handler
+	char* scratch;
+	size_t scratch_size;
+	// The types of the objects and arrays currently open
+	unsigned char* stack;
+	size_t depth;
+	size_t capacity;
+	// What is expected next, one of the JSON_PARSE states, kept between the chunks of json_parser_feed
+	int state;
+	// Why and at which character parsing failed, JSON_ERROR_NONE until it does
+	int error;
+	char* error_at;
+	// Set if more input may follow end, running out of input then pauses parsing instead of failing
+	int more;
+	// Set when parsing paused at end and waits for more input
+	int incomplete;
+	// The start of a string, number, or literal cut off at the end of a chunk, completed by the next chunk
+	char* carry;
+	size_t carry_len;
+	size_t carry_capacity;
+	// Set if the carried string ends in a backslash
+	int carry_escape;
+	// Builds a tree from the events when the parser was created without handler
+	struct JSONLoader* loader;
+	// Set once parsing failed, or finished successfully
+	int failed;
+	int finished;
+	// The start of the string being parsed and the offset of it in the whole input, for the offset of errors
+	char* start;
+	size_t offset;
+	// The offset in the whole input of the carried token
+	size_t carry_offset;
+	// The number of bytes fed to json_parser_feed so far
+	size_t fed;
+};
+
+// Records why and at which character parsing failed
+// Returns NULL, to be returned in turn by the failing parse function
+static char* json_parser_fail(struct JSONParser* parser, int code, const char* at)
+{
+	parser->error = code;
+	parser->error_at = (char*)at;
+	return NULL;
+}
+
+// Grows the scratch buffer of the parser to hold at least size characters
+// Returns 0 if memory couldn't be allocated
+static int json_parser_reserve(struct JSONParser* parser, size_t size)
+{
+	if (size <= parser->scratch_size)
+		return 1;
+	size_t new_size = parser->scratch_size ? parser->scratch_size * 2 : 64;
+	while (new_size < size)
+		new_size *= 2;
+	char* tmp = JSON_REALLOC(parser->scratch, new_size);
+	if (tmp == NULL)
+	{
+		JSON_MESSAGE("Failed to allocate memory for string value");
+		return 0;
+	}
+	JSON_STATS_ALLOC(parser, new_size);
+	if (parser->scratch)
+		JSON_STATS_ADD(scratch_grows, 1);
+	parser->scratch = tmp;
+	parser->scratch_size = new_size;
+	return 1;
+}
+
+// Reads from start quote to end quote and takes escape characters into consideration
+// Reads no further than end
+// out is set to the unescaped string and len to its length
+// Strings without escape sequences point into str. Others are unescaped into the parser's scratch buffer, or in place
+// when parsing in situ, in which case all strings are also zero terminated
+// Returns a pointer to the character after the end quote, or NULL if the string is invalid
+static char* json_parse_string(struct JSONParser* parser, char* str, char** out, size_t* len)
+{
+	char* end = parser->end;
+	// Skip past start quote
+	str++;
+
+	// Find the end of the string, the common case without escape sequences needs no copy
+	char* p = (char*)json_find_special(str, end, 0);
+	if (p < end && *p == '"')
+	{
+#ifdef JSON_VALIDATE_UTF8
+		const char* invalid = json_utf8_invalid(str, p);
+		if (invalid)
+			return json_parser_fail(parser, JSON_ERROR_UTF8, invalid);
+#endif
+		*out = str;
+		*len = p - str;
+		if (parser->insitu)
+			*p = '\0';
+		return p + 1;
+	}
+
+	// Unescape in place, where the unescaped string is never longer than the quoted one, or into scratch
+	char* result;
+	if (parser->insitu)
+		result = str;
+	else
+	{
+		if (!json_parser_reserve(parser, p - str + 1))
+			return json_parser_fail(parser, JSON_ERROR_MEMORY, str);
+		result = parser->scratch;
+		memcpy(result, str, p - str);
+	}
+	*out = result;
+	result += p - str;
+
+	for (str = p; str < end; str++)
+	{
 		char c = *str;
 
-		// Allocate more space for string
-		if (valit + 1 >= lval)
+		// Room for the longest character an escape sequence decodes to
+		if (!parser->insitu && (size_t)(result - parser->scratch) + 4 >= parser->scratch_size)
+		{
+			size_t used = result - parser->scratch;
+			if (!json_parser_reserve(parser, used + 5))
+				return json_parser_fail(parser, JSON_ERROR_MEMORY, str);
+			*out = parser->scratch;
+			result = parser->scratch + used;
+		}
+
+		// Escape sequence
+		if (c == '\\')
+		{
+			// The escape sequence continues in the next chunk
+			if (str + 1 == end && parser->more)
+				break;
+			if (str + 1 < end && str[1] == 'u')
+			{
+				int written;
+				int len = json_unescape_unicode(str, end, result, &written);
+				if (len < 0 && parser->more)
+					break;
+				if (len <= 0)
+					return json_parser_fail(parser, JSON_ERROR_ESCAPE, str);
+				result += written;
+				str += len - 1;
+				continue;
+			}
+			int escaped = str + 1 < end ? json_unescape(str[1]) : -1;
+			if (escaped < 0)
+				return json_parser_fail(parser, str + 1 < end ? JSON_ERROR_ESCAPE : JSON_ERROR_END, str);
+			*result++ = escaped;
+			str++;
+			continue;
+		}
+
+		if ((unsigned char)c < 0x20)
+			return json_parser_fail(parser, JSON_ERROR_CONTROL, str);
+
+		// End quote
+		if (c == '"')
+		{
+#ifdef JSON_VALIDATE_UTF8
+			// The unescaped string doesn't line up with the input anymore, so the error is at the end quote
+			if (json_utf8_invalid(*out, result))
+				return json_parser_fail(parser, JSON_ERROR_UTF8, str);
+#endif
+			*len = result - *out;
+			if (parser->insitu)
+				*result = '\0';
+			return str + 1;
+		}
+
+		// Normal characters up to the next escape sequence or end quote are copied at once
+		size_t run = json_find_special(str, end, 0) - str;
+		if (!parser->insitu && (size_t)(result - parser->scratch) + run + 1 >= parser->scratch_size)
+		{
+			size_t used = result - parser->scratch;
+			if (!json_parser_reserve(parser, used + run + 2))
+				return json_parser_fail(parser, JSON_ERROR_MEMORY, str);
+			*out = parser->scratch;
+			result = parser->scratch + used;
+		}
+		memmove(result, str, run);
+		result += run;
+		str += run - 1;
+	}
+	if (parser->more)
+	{
+		parser->incomplete = 1;
+		return NULL;
+	}
+	return json_parser_fail(parser, JSON_ERROR_END, end);
+}
+
+// Grows the stack of open objects and arrays by one for the bracket at str
+// Returns 0 if the objects and arrays are nested too deep or memory couldn't be allocated
+static int json_parser_push(struct JSONParser* parser, char* str, unsigned char type)
+{
+	if (parser->depth >= JSON_MAX_DEPTH)
+	{
+		json_parser_fail(parser, JSON_ERROR_DEPTH, str);
+		return 0;
+	}
+	if (parser->depth == parser->capacity)
+	{
+		size_t capacity = parser->capacity ? parser->capacity * 2 : 32;
+		unsigned char* tmp = JSON_REALLOC(parser->stack, capacity);
+		if (tmp == NULL)
+		{
+			JSON_MESSAGE("Failed to allocate memory for parsing");
+			json_parser_fail(parser, JSON_ERROR_MEMORY, str);
+			return 0;
+		}
+		JSON_STATS_ALLOC(parser, capacity);
+		parser->stack = tmp;
+		parser->capacity = capacity;
+	}
+	parser->stack[parser->depth++] = type;
+	return 1;
+}
+
+// Calls a callback of the parser's handler if it is set, and stops parsing at str if it returns non zero
+#define JSON_EMIT(parser, str, callback, args)                             \
+	if ((parser)->handler->callback && (parser)->handler->callback args) \
+		return json_parser_fail((parser), JSON_ERROR_STOPPED, (str));
+
+// States of json_parse_internal
+// A value is expected
+#define JSON_PARSE_VALUE 0
+// The name of a member is expected
+#define JSON_PARSE_KEY 1
+// A comma or the end of the innermost object or array is expected
+#define JSON_PARSE_NEXT 2
+// The colon after the name of a member is expected
+#define JSON_PARSE_COLON 3
+// The first name of an object or its end is expected
+#define JSON_PARSE_FIRST_KEY 4
+// The first value of an array or its end is expected
+#define JSON_PARSE_FIRST_VALUE 5
+
+// Returns non zero if the literal lit of length len is cut off by the end of the chunk at str
+static int json_literal_cut(const char* str, const char* end, const char* lit, size_t len)
+{
+	return (size_t)(end - str) < len && memcmp(str, lit, end - str) == 0;
+}
+
+// Parses a json value from str and passes its events to the parser's handler
+// Nested objects and arrays are kept on the parser's stack instead of recursing
+// Parsing continues in the parser's state, so it can pause at the end of a chunk when more input may follow and resume
+// with the next one
+// Returns a pointer to the first character that isn't whitespace after the value, or NULL if it's invalid or a
+// callback stopped parsing. When paused, incomplete is set and the start of the cut off token is returned
+static char* json_parse_value(struct JSONParser* parser, char* str)
+{
+	char* end = parser->end;
+	void* ctx = parser->ctx;
+	for (;;)
+	{
+#if JSON_SSE2
+		// Runs of whitespace such as indentation are skipped a vector at a time
+		if (end - str > 1 && JSON_IS_WHITESPACE(str[0]) && JSON_IS_WHITESPACE(str[1]))
+			str = json_skip_whitespace(str, end);
+#endif
+		while (str < end && JSON_IS_WHITESPACE(*str))
+			str++;
+
+		// The outermost value is done
+		if (parser->state == JSON_PARSE_NEXT && parser->depth == 0)
+			return str;
+
+		if (str == end)
+		{
+			if (parser->more)
+			{
+				parser->incomplete = 1;
+				return str;
+			}
+			return json_parser_fail(parser, JSON_ERROR_END, str);
+		}
+
+		if (parser->state == JSON_PARSE_NEXT)
+		{
+			unsigned char type = parser->stack[parser->depth - 1];
+			if (*str == ',')
+			{
+				str++;
+				parser->state = type == JSON_TOBJECT ? JSON_PARSE_KEY : JSON_PARSE_VALUE;
+				continue;
+			}
+			if (type == JSON_TOBJECT && *str == '}')
+			{
+				str++;
+				parser->depth--;
+				JSON_EMIT(parser, str, end_object, (ctx));
+				continue;
+			}
+			if (type == JSON_TARRAY && *str == ']')
+			{
+				str++;
+				parser->depth--;
+				JSON_EMIT(parser, str, end_array, (ctx));
+				continue;
+			}
+			return json_parser_fail(parser, JSON_ERROR_COMMA, str);
+		}
+
+		if (parser->state == JSON_PARSE_COLON)
+		{
+			if (*str != ':')
+				return json_parser_fail(parser, JSON_ERROR_COLON, str);
+			str++;
+			parser->state = JSON_PARSE_VALUE;
+			continue;
+		}
+
+		// End of empty object
+		if (parser->state == JSON_PARSE_FIRST_KEY && *str == '}')
+		{
+			str++;
+			parser->depth--;
+			parser->state = JSON_PARSE_NEXT;
+			JSON_EMIT(parser, str, end_object, (ctx));
+			continue;
+		}
+
+		// End of empty array
+		if (parser->state == JSON_PARSE_FIRST_VALUE && *str == ']')
+		{
+			str++;
+			parser->depth--;
+			parser->state = JSON_PARSE_NEXT;
+			JSON_EMIT(parser, str, end_array, (ctx));
+			continue;
+		}
+
+		// Read the name, the colon follows
+		if (parser->state == JSON_PARSE_KEY || parser->state == JSON_PARSE_FIRST_KEY)
+		{
+			char* name;
+			size_t len;
+			if (*str != '"')
+				return json_parser_fail(parser, JSON_ERROR_NAME, str);
+			char* tmp = json_parse_string(parser, str, &name, &len);
+			if (tmp == NULL)
+				return parser->incomplete ? str : NULL;
+			str = tmp;
+			parser->state = JSON_PARSE_COLON;
+			JSON_EMIT(parser, str, key, (ctx, name, len));
+			continue;
+		}
+
+		// Object
+		if (*str == '{')
+		{
+			str++;
+			if (!json_parser_push(parser, str - 1, JSON_TOBJECT))
+				return NULL;
+			parser->state = JSON_PARSE_FIRST_KEY;
+			JSON_EMIT(parser, str, start_object, (ctx));
+		}
+
+		// Array
+		else if (*str == '[')
+		{
+			str++;
+			if (!json_parser_push(parser, str - 1, JSON_TARRAY))
+				return NULL;
+			parser->state = JSON_PARSE_FIRST_VALUE;
+			JSON_EMIT(parser, str, start_array, (ctx));
+		}
+
+		// String
+		else if (*str == '"')
+		{
+			char* val;
+			size_t len;
+			char* tmp = json_parse_string(parser, str, &val, &len);
+			if (tmp == NULL)
+				return parser->incomplete ? str : NULL;
+			str = tmp;
+			parser->state = JSON_PARSE_NEXT;
+			JSON_EMIT(parser, str, string, (ctx, val, len));
+		}
+
+		// Number
+		else if ((*str >= '0' && *str <= '9') || *str == '-' || *str == '+')
+		{
+			// A number running up to the end of the chunk may continue in the next one
+			if (parser->more)
+			{
+				char* p = str;
+				while (p < end && ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' || *p == '.' || *p == 'e' ||
+								   *p == 'E'))
+					p++;
+				if (p == end)
+				{
+					parser->incomplete = 1;
+					return str;
+				}
+			}
+			struct JSONNumber num;
+			char* tmp = json_read_number(str, end, &num);
+			if (tmp == NULL)
+				return json_parser_fail(parser, JSON_ERROR_NUMBER, str);
+			str = tmp;
+			parser->state = JSON_PARSE_NEXT;
+			if (num.integer && parser->handler->integer)
+			{
+				JSON_EMIT(parser, str, integer, (ctx, num.val.intval));
+			}
+			else
+			{
+				JSON_EMIT(parser, str, number, (ctx, num.integer ? (double)num.val.intval : num.val.numval));
+			}
+		}
+
+		// Bool true
+		else if (end - str >= 4 && memcmp(str, "true", 4) == 0)
+		{
+			str += 4;
+			parser->state = JSON_PARSE_NEXT;
+			JSON_EMIT(parser, str, boolean, (ctx, 1));
+		}
+
+		// Bool false
+		else if (end - str >= 5 && memcmp(str, "false", 5) == 0)
+		{
+			str += 5;
+			parser->state = JSON_PARSE_NEXT;
+			JSON_EMIT(parser, str, boolean, (ctx, 0));
+		}
+
+		else if (end - str >= 4 && memcmp(str, "null", 4) == 0)
+		{
+			str += 4;
+			parser->state = JSON_PARSE_NEXT;
+			JSON_EMIT(parser, str, null, (ctx));
+		}
+
+		// A literal continuing in the next chunk
+		else if (parser->more && (json_literal_cut(str, end, "true", 4) || json_literal_cut(str, end, "false", 5) ||
+								  json_literal_cut(str, end, "null", 4)))
+		{
+			parser->incomplete = 1;
+			return str;
+		}
+
+		else
+			return json_parser_fail(parser, JSON_ERROR_VALUE, str);
+	}
+}
+
+#ifdef JSON_STATS
+// Counts the time and bytes of every run of the parser
+static char* json_parse_internal(struct JSONParser* parser, char* str)
+{
+	uint64_t start = json_stats_now();
+	char* result = json_parse_value(parser, str);
+	char* stop = result ? result : parser->error ? parser->error_at : parser->end;
+	JSON_STATS_ADD(parses, 1);
+	JSON_STATS_ADD(parse_bytes, stop - str);
+	JSON_STATS_ADD(parse_ns, json_stats_now() - start);
+	return result;
+}
+#else
+#define json_parse_internal json_parse_value
+#endif
+
+const char* json_error_string(int code)
+{
+	switch (code)
+	{
+	case JSON_ERROR_NONE:
+		return "No error";
+	case JSON_ERROR_MEMORY:
+		return "Failed to allocate memory";
+	case JSON_ERROR_END:
+		return "Unexpected end of json";
+	case JSON_ERROR_VALUE:
+		return "Invalid value";
+	case JSON_ERROR_NAME:
+		return "Expected member name";
+	case JSON_ERROR_COLON:
+		return "Expected ':' after member name";
+	case JSON_ERROR_COMMA:
+		return "Expected ',' or end of object or array";
+	case JSON_ERROR_NUMBER:
+		return "Expected digit in number";
+	case JSON_ERROR_ESCAPE:
+		return "Invalid escape sequence";
+	case JSON_ERROR_CONTROL:
+		return "Control character in string";
+	case JSON_ERROR_UTF8:
+		return "Invalid UTF-8 in string";
+	case JSON_ERROR_DEPTH:
+		return "Objects and arrays nested too deep";
+	case JSON_ERROR_TRAILING:
+		return "Unexpected character after json";
+	case JSON_ERROR_STOPPED:
+		return "Stopped by callback";
+	}
+	return "Unknown error";
+}
+
+// Sets error to why and where the parser failed, with the line and column counted from the start of its string
+// Lines are only counted once parsing failed, so valid json costs nothing extra
+static void json_parser_report(struct JSONParser* parser, JSONError* error)
+{
+	char* at = parser->error_at;
+	error->code = parser->error;
+	error->offset = parser->offset + (at - parser->start);
+	error->line = 1;
+	char* line_start = parser->start;
+	for (char* p = line_start; (p = memchr(p, '\n', at - p)) != NULL; p++)
+	{
+		error->line++;
+		line_start = p + 1;
+	}
+	error->column = at - line_start + 1;
+}
+
+// Sets error, if not NULL, to memory running out before any json was read
+static void json_error_memory(JSONError* error)
+{
+	if (error)
+		*error = (JSONError){JSON_ERROR_MEMORY, 0, 1, 1};
+}
+
+// Passes why and where the json of source is invalid to JSON_MESSAGE, for the functions without a JSONError
+static void json_error_message(const char* source, const JSONError* error)
+{
+	char msg[512];
+	snprintf(msg, sizeof msg, "%.256s contains invalid json data at line %zu, column %zu: %s", source, error->line,
+			 error->column, json_error_string(error->code));
+	JSON_MESSAGE(msg);
+}
+
+int json_parse(const char* buf, size_t len, const JSONHandler* handler, void* ctx)
+{
+	JSONError error;
+	int result = json_parse_error(buf, len, handler, ctx, &error);
+	if (result == -1)
+		json_error_message("String", &error);
+	return result;
+}
+
+int json_parse_error(const char* buf, size_t len, const JSONHandler* handler, void* ctx, JSONError* error)
+{
+	// The buffer is only written to when parsing in situ
+	struct JSONParser parser = {.handler = handler, .ctx = ctx, .end = (char*)buf + len, .start = (char*)buf};
+	char* str = json_parse_internal(&parser, (char*)buf);
+	if (str && str != parser.end)
+		str = json_parser_fail(&parser, JSON_ERROR_TRAILING, str);
+	JSON_FREE(parser.scratch);
+	JSON_FREE(parser.stack);
+	if (str)
+		return 0;
+	json_parser_report(&parser, error);
+	return parser.error == JSON_ERROR_STOPPED ? -2 : -1;
+}
+
+// The members of an object or elements of an array
+// The names of an object's members are stored once here instead of in each member
+struct JSONChildren
+{
+	// The number of children
+	int count;
+	// The number of used slots, including the holes left by popped members
+	int length;
+	int capacity;
+	// Hash index of the members' names, only for objects with many members
+	struct JSONIndex* index;
+	// Names of an object's members, parallel to items, NULL for arrays
+	char** names;
+	// Popped members leave a NULL hole until the object is compacted
+	JSON* items[];
+};
+
+// Objects get a hash index of their member names when reaching this many members
+#ifndef JSON_INDEX_THRESHOLD
+#define JSON_INDEX_THRESHOLD 8
+#endif
+
+#define JSON_INDEX_EMPTY	 -1
+#define JSON_INDEX_TOMBSTONE -2
+
+struct JSONIndexEntry
+{
+	unsigned int hash;
+	// The slot of the member in the children, or JSON_INDEX_EMPTY or JSON_INDEX_TOMBSTONE
+	int slot;
+};
+
+// Open addressing hash table mapping names to the slots of an object's members
+// Insertion order is still kept by the slots
+struct JSONIndex
+{
+	// Power of two
+	size_t capacity;
+	// Number of entries that are not empty, including tombstones
+	size_t used;
+	struct JSONIndexEntry entries[];
+};
+
+// FNV-1a
+static size_t json_hash(const char* str)
+{
+	size_t hash = (size_t)14695981039346656037ULL;
+	for (; *str != '\0'; str++)
+	{
+		hash ^= (unsigned char)*str;
+		hash *= (size_t)1099511628211ULL;
+	}
+	return hash;
+}
+
+// Returns the entry of the member with name, or NULL if it doesn't exist
+static struct JSONIndexEntry* json_index_find(struct JSONChildren* children, const char* name, unsigned int hash)
+{
+	struct JSONIndex* index = children->index;
+	size_t mask = index->capacity - 1;
+	for (size_t i = hash & mask;; i = (i + 1) & mask)
+	{
+		struct JSONIndexEntry* entry = &index->entries[i];
+		if (entry->slot == JSON_INDEX_EMPTY)
+			return NULL;
+		if (entry->hash == hash && entry->slot != JSON_INDEX_TOMBSTONE &&
+			(children->names[entry->slot] == name || strcmp(children->names[entry->slot], name) == 0))
+			return entry;
+	}
+}
+
+// Inserts a slot that is known to not be in the index
+static void json_index_put(struct JSONIndex* index, int slot, unsigned int hash)
+{
+	size_t mask = index->capacity - 1;
+	size_t i = hash & mask;
+	while (index->entries[i].slot != JSON_INDEX_EMPTY)
+		i = (i + 1) & mask;
+	index->entries[i].hash = hash;
+	index->entries[i].slot = slot;
+	index->used++;
+}
+
+// Allocates an empty index with room for count members
+// Returns NULL if memory couldn't be allocated
+static struct JSONIndex* json_index_create(struct JSONArena* arena, int count)
+{
+	size_t capacity = 16;
+	while (capacity < (size_t)count * 2)
+		capacity *= 2;
+
+	struct JSONIndex* index =
+		json_alloc(arena, sizeof(struct JSONIndex) + capacity * sizeof(struct JSONIndexEntry));
+	if (index == NULL)
+		return NULL;
+	JSON_STATS_ALLOC(children, sizeof(struct JSONIndex) + capacity * sizeof(struct JSONIndexEntry));
+	index->capacity = capacity;
+	index->used = 0;
+	for (size_t i = 0; i < capacity; i++)
+		index->entries[i].slot = JSON_INDEX_EMPTY;
+	return index;
+}
+
+// (Re)builds the index of an object's members, dropping all tombstones
+// Without memory for it the object has no index and is searched instead
+static void json_index_build(struct JSONChildren* children)
+{
+	struct JSONIndex* index = json_index_create(NULL, children->count);
+	for (int i = 0; index && i < children->length; i++)
+	{
+		if (children->items[i])
+			json_index_put(index, i, json_hash(children->names[i]));
+	}
+
+	JSON_FREE(children->index);
+	children->index = index;
+}
+
+// The number of names after which a loader stops sharing names if most of them were distinct
+#define JSON_KEYS_SAMPLE 256
+
+struct JSONKeyEntry
+{
+	size_t hash;
+	size_t len;
+	// NULL if the entry is empty
+	char* name;
+};
+
+// Open addressing hash table of member names, so that equal names share one copy
+struct JSONKeys
+{
+	// Owns the copies of the names
+	struct JSONArena* arena;
+	// The arena of a table made with json_keys_create
+	struct JSONArena own;
+	// Power of two, 0 until the first name is added
+	size_t capacity;
+	size_t count;
+	// No names are added once the table holds limit names
+	size_t limit;
+	struct JSONKeyEntry* entries;
+};
+
+// FNV-1a of len bytes
+static size_t json_hash_bytes(const char* str, size_t len)
+{
+	size_t hash = (size_t)14695981039346656037ULL;
+	for (size_t i = 0; i < len; i++)
+	{
+		hash ^= (unsigned char)str[i];
+		hash *= (size_t)1099511628211ULL;
+	}
+	return hash;
+}
+
+// Doubles the entries of the table
+static int json_keys_grow(struct JSONKeys* keys)
+{
+	size_t capacity = keys->capacity ? keys->capacity * 2 : 64;
+	struct JSONKeyEntry* entries = JSON_MALLOC(capacity * sizeof(struct JSONKeyEntry));
+	if (entries == NULL)
+		return -1;
+	JSON_STATS_ALLOC(names, capacity * sizeof(struct JSONKeyEntry));
+	for (size_t i = 0; i < capacity; i++)
+		entries[i].name = NULL;
+
+	for (size_t i = 0; i < keys->capacity; i++)
+	{
+		if (keys->entries[i].name == NULL)
+			continue;
+		size_t j = keys->entries[i].hash & (capacity - 1);
+		while (entries[j].name)
+			j = (j + 1) & (capacity - 1);
+		entries[j] = keys->entries[i];
+	}
+	JSON_FREE(keys->entries);
+	keys->entries = entries;
+	keys->capacity = capacity;
+	return 0;
+}
+
+// Returns the shared copy of the name of len bytes, which is added if add is set and the table isn't full
+// Returns NULL if the name isn't shared
+static char* json_keys_find(struct JSONKeys* keys, const char* name, size_t len, int add)
+{
+	size_t hash = json_hash_bytes(name, len);
+	size_t i = 0;
+	if (keys->capacity)
+	{
+		size_t mask = keys->capacity - 1;
+		for (i = hash & mask; keys->entries[i].name; i = (i + 1) & mask)
+		{
+			struct JSONKeyEntry* entry = &keys->entries[i];
+			if (entry->hash == hash && entry->len == len && memcmp(entry->name, name, len) == 0)
+				return entry->name;
+		}
+	}
+	if (!add || keys->count >= keys->limit)
+		return NULL;
+
+	// Keep the load factor at most 1/2
+	if ((keys->count + 1) * 2 > keys->capacity)
+	{
+		if (json_keys_grow(keys))
+			return NULL;
+		for (i = hash & (keys->capacity - 1); keys->entries[i].name; i = (i + 1) & (keys->capacity - 1))
+			;
+	}
+	char* copy = json_arena_alloc(keys->arena, len + 1);
+	if (copy == NULL)
+		return NULL;
+	JSON_STATS_ALLOC(names, len + 1);
+	memcpy(copy, name, len);
+	copy[len] = '\0';
+	keys->entries[i] = (struct JSONKeyEntry){hash, len, copy};
+	keys->count++;
+	return copy;
+}
+
+// Prepares a table sharing at most limit names, copied into arena
+static void json_keys_init(struct JSONKeys* keys, struct JSONArena* arena, size_t limit)
+{
+	keys->arena = arena;
+	keys->capacity = 0;
+	keys->count = 0;
+	keys->limit = limit;
+	keys->entries = NULL;
+}
+
+// Allocates children with room for capacity members or elements
+// Returns NULL if memory couldn't be allocated
+static struct JSONChildren* json_children_create(struct JSONArena* arena, int type, int capacity)
+{
+	size_t size = sizeof(struct JSONChildren) + capacity * sizeof(JSON*);
+	if (type == JSON_TOBJECT)
+		size += capacity * sizeof(char*);
+
+	struct JSONChildren* children = json_alloc(arena, size);
+	if (children == NULL)
+	{
+		JSON_MESSAGE("Failed to allocate memory for children");
+		return NULL;
+	}
+	JSON_STATS_ALLOC(children, size);
+	children->count = 0;
+	children->length = 0;
+	children->capacity = capacity;
+	children->index = NULL;
+	children->names = type == JSON_TOBJECT ? (char**)(children->items + capacity) : NULL;
+	return children;
+}
+
+// Removes the holes left by popped members
+static void json_children_compact(struct JSONChildren* children)
+{
+	int length = 0;
+	for (int i = 0; i < children->length; i++)
+	{
+		JSON* item = children->items[i];
+		if (item == NULL)
+			continue;
+		children->items[length] = item;
+		if (children->names)
+			children->names[length] = children->names[i];
+		item->pos = length++;
+	}
+	children->length = length;
+
+	if (children->index)
+		json_index_build(children);
+}
+
+// Makes room for one more child at the end of an object or array
+static int json_children_reserve(JSON* object)
+{
+	struct JSONChildren* children = object->val.children;
+	if (children && children->length < children->capacity)
+		return 0;
+
+	// Reuse the holes if at least a quarter of the slots are empty
+	if (children && (children->length - children->count) * 4 >= children->length)
+	{
+		json_children_compact(children);
+		return 0;
+	}
+
+	// Grow geometrically for amortized constant time appends
+	int old_capacity = children ? children->capacity : 0;
+	int capacity = old_capacity ? old_capacity * 2 : 4;
+	size_t size = sizeof(struct JSONChildren) + capacity * sizeof(JSON*);
+	if (object->type == JSON_TOBJECT)
+		size += capacity * sizeof(char*);
+
+	struct JSONChildren* tmp = JSON_REALLOC(children, size);
+	if (tmp == NULL)
+	{
+		JSON_MESSAGE("Failed to allocate memory for children");
+		return -1;
+	}
+	JSON_STATS_ALLOC(children, size);
+	if (children == NULL)
+	{
+		tmp->count = 0;
+		tmp->length = 0;
+		tmp->index = NULL;
+	}
+	tmp->capacity = capacity;
+	// The names follow the items, move them after the grown items
+	if (object->type == JSON_TOBJECT)
+	{
+		tmp->names = (char**)(tmp->items + capacity);
+		memmove(tmp->names, tmp->items + old_capacity, tmp->length * sizeof(char*));
+	}
+	else
+		tmp->names = NULL;
+	object->val.children = tmp;
+	return 0;
+}
+
+// Allocates an empty node from arena, or with JSON_MALLOC if arena is NULL
+// Returns NULL if memory couldn't be allocated
+static JSON* json_create_node(struct JSONArena* arena)
+{
+	JSON* object = json_alloc(arena, sizeof(JSON));
+	if (object == NULL)
+	{
+		JSON_MESSAGE("Failed to allocate memory for node");
+		return NULL;
+	}
+	JSON_STATS_ALLOC(nodes, sizeof(JSON));
+	object->type = JSON_TINVALID;
+	object->flags = 0;
+	object->pos = 0;
+	object->up.parent = NULL;
+	object->val.numval = 0;
+	return object;
+}
+
+// Constructors
+JSON* json_create_empty()
+{
+	return json_create_node(NULL);
+}
+JSON* json_create_null()
+{
+	JSON* object = json_create_empty();
+	object->type = JSON_TNULL;
+	return object;
+}
+
+JSON* json_create_string(const char* str)
+{
+	JSON* object = json_create_empty();
+	object->type = JSON_TSTRING;
+	object->val.stringval = strduplicate(str);
+	JSON_STATS_ALLOC(strings, strlen(str) + 1);
+	return object;
+}
+
+JSON* json_create_number(double value)
+{
+	JSON* object = json_create_empty();
+	object->type = JSON_TNUMBER;
+	object->val.numval = value;
+	return object;
+}
+
+JSON* json_create_integer(int64_t value)
+{
+	JSON* object = json_create_empty();
+	object->type = JSON_TNUMBER;
+	object->flags |= JSON_FLAG_INTEGER;
+	object->val.intval = value;
+	return object;
+}
+
+JSON* json_create_object()
+{
+	JSON* object = json_create_empty();
+	object->type = JSON_TOBJECT;
+	object->val.children = NULL;
+	return object;
+}
+
+JSON* json_create_array()
+{
+	JSON* object = json_create_empty();
+	object->type = JSON_TARRAY;
+	object->val.children = NULL;
+	return object;
+}
+
+// Frees the string or destroys all members or elements of an object
+// Nested objects and arrays are freed from their last child up, descending into a child with children of its own and
+// climbing back up through the parent once they are all freed, so any depth is destroyed without using the stack
+static void json_destroy_value(JSON* object)
+{
+	if (object->type == JSON_TSTRING)
+	{
+		JSON_FREE(object->val.stringval);
+	}
+	else if ((object->type == JSON_TOBJECT || object->type == JSON_TARRAY) && object->val.children)
+	{
+		JSON* node = object;
+		for (;;)
+		{
+			struct JSONChildren* children = node->val.children;
+			JSON* nested = NULL;
+			for (; children->length > 0; children->length--)
+			{
+				JSON* item = children->items[children->length - 1];
+				if (item && (item->type == JSON_TOBJECT || item->type == JSON_TARRAY) && item->val.children)
+				{
+					nested = item;
+					break;
+				}
+				if (item == NULL)
+					continue;
+				if (children->names && !(item->flags & JSON_FLAG_SHARED))
+					JSON_FREE(children->names[children->length - 1]);
+				if (item->type == JSON_TSTRING)
+					JSON_FREE(item->val.stringval);
+				JSON_FREE(item);
+			}
+			if (nested)
+			{
+				nested->up.parent = node;
+				node = nested;
+				continue;
+			}
+
+			// The emptied object or array is freed by its parent like any other child
+			JSON_FREE(children->index);
+			JSON_FREE(children);
+			node->val.children = NULL;
+			if (node == object)
+				break;
+			node = node->up.parent;
+		}
+	}
+	object->flags &= ~JSON_FLAG_INTEGER;
+	object->val.numval = 0;
+}
+
+void json_set_invalid(JSON* object)
+{
+	// If previous type was object or array, destroy members
+	json_destroy_value(object);
+	object->type = JSON_TINVALID;
+}
+
+// Setters
+void json_set_string(JSON* object, const char* str)
+{
+	json_set_invalid(object);
+	object->type = JSON_TSTRING;
+	object->val.stringval = strduplicate(str);
+	JSON_STATS_ALLOC(strings, strlen(str) + 1);
+}
+
+void json_set_number(JSON* object, double num)
+{
+	json_set_invalid(object);
+	object->type = JSON_TNUMBER;
+	object->val.numval = num;
+}
+
+void json_set_integer(JSON* object, int64_t num)
+{
+	json_set_invalid(object);
+	object->type = JSON_TNUMBER;
+	object->flags |= JSON_FLAG_INTEGER;
+	object->val.intval = num;
+}
+
+void json_set_bool(JSON* object, int val)
+{
+	json_set_invalid(object);
+	object->type = JSON_TBOOL;
+	object->val.numval = val;
+}
+
+void json_set_null(JSON* object)
+{
+	json_set_invalid(object);
+	object->type = JSON_TNULL;
+}
+
+const char* json_get_name(JSON* object)
+{
+	if (object->flags & JSON_FLAG_NAME)
+		return object->up.name;
+	JSON* parent = object->up.parent;
+	if (parent && parent->type == JSON_TOBJECT)
+		return parent->val.children->names[object->pos];
+	return NULL;
+}
+
+int json_get_type(JSON* object)
+{
+	return object->type;
+}
+
+char* json_get_string(JSON* object)
+{
+	if (object->type != JSON_TSTRING)
+		return NULL;
+	return object->val.stringval;
+}
+
+double json_get_number(JSON* object)
+{
+	if (object->type != JSON_TNUMBER && object->type != JSON_TBOOL)
+		return 0;
+	if (object->flags & JSON_FLAG_INTEGER)
+		return object->val.intval;
+	return object->val.numval;
+}
+
+int64_t json_get_integer(JSON* object)
+{
+	if (object->flags & JSON_FLAG_INTEGER)
+		return object->val.intval;
+	if (object->type != JSON_TNUMBER && object->type != JSON_TBOOL)
+		return 0;
+
+	// Converting a double outside the range of int64_t is undefined, so those saturate instead
+	double number = object->val.numval;
+	if (number != number)
+		return 0;
+	if (number >= 9223372036854775808.0)
+		return INT64_MAX;
+	if (number < -9223372036854775808.0)
+		return INT64_MIN;
+	return (int64_t)number;
+}
+
+int json_get_bool(JSON* object)
+{
+	if (object->type != JSON_TNUMBER && object->type != JSON_TBOOL)
+		return 0;
+	if (object->flags & JSON_FLAG_INTEGER)
+		return object->val.intval != 0;
+	return object->val.numval;
+}
+
+char* json_get_member_string(JSON* object, const char* name)
+{
+	JSON* tmp = json_get_member(object, name);
+	if (tmp == NULL)
+		return NULL;
+	return json_get_string(tmp);
+}
+
+// Gets a member of an object and returns its number value
+double json_get_member_number(JSON* object, const char* name)
+{
+	JSON* tmp = json_get_member(object, name);
+	if (tmp == NULL)
+		return 0;
+	return json_get_number(tmp);
+}
+
+// Gets a member of an object and returns its integer value
+int64_t json_get_member_integer(JSON* object, const char* name)
+{
+	JSON* tmp = json_get_member(object, name);
+	if (tmp == NULL)
+		return 0;
+	return json_get_integer(tmp);
+}
+
+// Gets a member of an object and returns its bool value
+int json_get_member_bool(JSON* object, const char* name)
+{
+	JSON* tmp = json_get_member(object, name);
+	if (tmp == NULL)
+		return 0;
+	return json_get_bool(tmp);
+}
+
+// Returns the first child at or after slot, or NULL
+static JSON* json_children_next(struct JSONChildren* children, int slot)
+{
+	for (; slot < children->length; slot++)
+	{
+		if (children->items[slot])
+			return children->items[slot];
+	}
+	return NULL;
+}
+
+JSON* json_get_members(JSON* object)
+{
+	if (object->type != JSON_TOBJECT || object->val.children == NULL)
+		return NULL;
+	return json_children_next(object->val.children, 0);
+}
+
+// Returns the slot of the member with name, or -1 if it doesn't exist
+static int json_find_slot(struct JSONChildren* children, const char* name)
+{
+	if (children->index)
+	{
+		struct JSONIndexEntry* entry = json_index_find(children, name, json_hash(name));
+		return entry ? entry->slot : -1;
+	}
+	// A shared name is found by its pointer before any string is compared
+	for (int i = 0; i < children->length; i++)
+	{
+		if (children->items[i] && children->names[i] == name)
+			return i;
+	}
+	for (int i = 0; i < children->length; i++)
+	{
+		if (children->items[i] && strcmp(children->names[i], name) == 0)
+			return i;
+	}
+	return -1;
+}
+
+JSON* json_get_member(JSON* object, const char* name)
+{
+	if (object->type != JSON_TOBJECT || object->val.children == NULL)
+		return NULL;
+	int slot = json_find_slot(object->val.children, name);
+	return slot < 0 ? NULL : object->val.children->items[slot];
+}
+
+JSON* json_get_member_cached(JSON* object, const char* name, int* slot)
+{
+	if (object->type != JSON_TOBJECT || object->val.children == NULL)
+		return NULL;
+	struct JSONChildren* children = object->val.children;
+	int i = *slot;
+	if (i >= 0 && i < children->length && children->items[i] &&
+		(children->names[i] == name || strcmp(children->names[i], name) == 0))
+		return children->items[i];
+
+	// Keep the slot of the last object the member was found in
+	i = json_find_slot(children, name);
+	if (i < 0)
+		return NULL;
+	*slot = i;
+	return children->items[i];
+}
+
+// Returns the first element of a json array
+JSON* json_get_elements(JSON* object)
+{
+	if (object->type != JSON_TARRAY || object->val.children == NULL)
+		return NULL;
+	return json_children_next(object->val.children, 0);
+}
+
+JSON* json_get_element(JSON* object, int index)
+{
+	if (object->type != JSON_TARRAY || object->val.children == NULL || index < 0 ||
+		index >= object->val.children->length)
+		return NULL;
+	return object->val.children->items[index];
+}
+
+int json_get_count(JSON* object)
+{
+	if ((object->type != JSON_TOBJECT && object->type != JSON_TARRAY) || object->val.children == NULL)
+		return 0;
+	return object->val.children->count;
+}
+
+// Returns the next item in the list element is a part of
+JSON* json_get_next(JSON* element)
+{
+	if ((element->flags & JSON_FLAG_NAME) || element->up.parent == NULL)
+		return NULL;
+	return json_children_next(element->up.parent->val.children, element->pos + 1);
+}
+
+// Writes a string, number, bool or null
+static void json_tostring_scalar(JSON* object, struct JSONStringStream* ss, int format)
+{
+	if (object->type == JSON_TSTRING)
+	{
+		json_ss_write_quoted(ss, object->val.stringval, format & JSON_ASCII);
+	}
+	else if (object->type == JSON_TNUMBER)
+	{
+		// Format directly into the stream
+		if (!json_ss_reserve(ss, 32))
+			return;
+		char* buf = ss->str + ss->length;
+		if (object->flags & JSON_FLAG_INTEGER)
+			ss->length += json_itoa(object->val.intval, buf);
+		else
+			ss->length += json_dtoa(object->val.numval, buf);
+	}
+	else if (object->type == JSON_TBOOL)
+	{
+		if (object->val.numval)
+			json_ss_literal(ss, "true");
+		else
+			json_ss_literal(ss, "false");
+	}
+	else if (object->type == JSON_TNULL)
+	{
+		json_ss_literal(ss, "null");
+	}
+}
+
+// Nested objects and arrays are walked down through their children and back up through the parents instead of
+// recursing, so any depth can be written without using the stack
+static void json_tostring_value(JSON* object, struct JSONStringStream* ss, int format, size_t depth)
+{
+	if (object->type != JSON_TOBJECT && object->type != JSON_TARRAY)
+	{
+		json_tostring_scalar(object, ss, format);
+		return;
+	}
+
+	json_ss_write(ss, object->type == JSON_TOBJECT ? "{" : "[", 1);
+	JSON* node = object;
+	int slot = 0;
+	int written = 0;
+	for (;;)
+	{
+		struct JSONChildren* children = node->val.children;
+		JSON* nested = NULL;
+		for (; children && slot < children->length; slot++)
+		{
+			JSON* cur = children->items[slot];
+			if (cur == NULL)
+				continue;
+			if (written)
+				json_ss_literal(ss, ",");
+			written = 1;
+
+			// Format with tabs
+			if (format & JSON_FORMAT)
+				json_ss_indent(ss, depth + 1);
+			if (children->names)
+			{
+				json_ss_write_quoted(ss, children->names[slot], format & JSON_ASCII);
+				if (format & JSON_FORMAT)
+					json_ss_literal(ss, ": ");
+				else
+					json_ss_literal(ss, ":");
+			}
+			if (cur->type == JSON_TOBJECT || cur->type == JSON_TARRAY)
+			{
+				nested = cur;
+				break;
+			}
+			json_tostring_scalar(cur, ss, format);
+		}
+
+		// Continues with the first member or element of a nested object or array
+		if (nested)
+		{
+			json_ss_write(ss, nested->type == JSON_TOBJECT ? "{" : "[", 1);
+			node = nested;
+			slot = 0;
+			written = 0;
+			depth++;
+			continue;
+		}
+
+		// Closes the object or array and goes on after it in the parent
+		if (format & JSON_FORMAT && written)
+			json_ss_indent(ss, depth);
+		json_ss_write(ss, node->type == JSON_TOBJECT ? "}" : "]", 1);
+		if (node == object)
+			return;
+		slot = node->pos + 1;
+		node = node->up.parent;
+		written = 1;
+		depth--;
+	}
+}
+
+#ifdef JSON_STATS
+// Counts the time and bytes of writing every value
+static void json_tostring_internal(JSON* object, struct JSONStringStream* ss, int format, size_t depth)
+{
+	uint64_t start = json_stats_now();
+	size_t written = ss->flushed + ss->length;
+	json_tostring_value(object, ss, format, depth);
+	JSON_STATS_ADD(writes, 1);
+	JSON_STATS_ADD(write_bytes, ss->flushed + ss->length - written);
+	JSON_STATS_ADD(write_ns, json_stats_now() - start);
+}
+#else
+#define json_tostring_internal json_tostring_value
+#endif
+
+char* json_tostring(JSON* object, int format)
+{
+	char* buf = NULL;
+	size_t size = 0;
+	if (json_tobuffer(object, format, &buf, &size) == 0)
+	{
+		JSON_FREE(buf);
+		return NULL;
+	}
+	return buf;
+}
+
+size_t json_tobuffer(JSON* object, int format, char** buf, size_t* size)
+{
+	struct JSONStringStream ss = {.str = *buf, .size = *buf ? *size : 0};
+	json_tostring_internal(object, &ss, format, 0);
+	if (ss.str)
+		ss.str[ss.length] = '\0';
+	*buf = ss.str;
+	*size = ss.size;
+	return ss.failed ? 0 : ss.length;
+}
+
+int json_write_to(JSON* object, JSONWriteFn write, void* ctx, int format)
+{
+	struct JSONStringStream ss = {
+		.str = JSON_MALLOC(JSON_WRITE_BUFFER), .size = JSON_WRITE_BUFFER, .write = write, .ctx = ctx};
+	if (ss.str == NULL)
+	{
+		JSON_MESSAGE("Failed to allocate memory for string stream");
+		return -1;
+	}
+	JSON_STATS_ALLOC(writer, JSON_WRITE_BUFFER);
+	json_tostring_internal(object, &ss, format, 0);
+	if (!ss.failed && ss.length)
+		json_ss_flush(&ss);
+	JSON_FREE(ss.str);
+	return ss.failed ? -1 : 0;
+}
+
+int json_sink_file(void* ctx, const char* data, size_t len)
+{
+	return fwrite(data, 1, len, ctx) == len ? 0 : -1;
+}
+
+#if JSON_USE_POSIX
+int json_sink_fd(void* ctx, const char* data, size_t len)
+{
+	int fd = (int)(intptr_t)ctx;
+	while (len)
+	{
+		ssize_t written = write(fd, data, len);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		data += written;
+		len -= written;
+	}
+	return 0;
+}
+#endif
+
+int json_writefile(JSON* object, const char* filepath, int format)
+{
+// Create directories leading up
+#if JSON_USE_POSIX
+	const char* p = filepath;
+	char tmp_path[FILENAME_MAX];
+	size_t len = 0;
+	struct stat st = {0};
+	for (; *p != '\0'; p++)
+	{
+		// Dir separator hit, the root of an absolute path always exists
+		if (*p == '/' && p != filepath)
+		{
+			len = p - filepath;
+
+			memcpy(tmp_path, filepath, len);
+			tmp_path[len] = '\0';
+
+			// Dir already exists
+			if (stat(tmp_path, &st) == 0)
+			{
+				continue;
+			}
+			if (mkdir(tmp_path, 0777))
+			{
+				char msg[512];
+				snprintf(msg, sizeof msg, "Failed to create directory %s", tmp_path);
+				JSON_MESSAGE(msg);
+				return -1;
+			}
+		}
+	}
+#elif JSON_USE_WINAPI
+	char* p = filepath;
+	const char tmp_path[FILENAME_MAX];
+	for (; *p != '\0'; p++)
+	{
+		// Dir separator hit
+		if (*p == '/' || *p == '\\')
+		{
+			size_t len = p - filepath;
+			memcpy(tmp_path, filepath, p - filepath);
+			tmp_path[len] = '\0';
+			CreateDirectoryA(tmp_path, NULL);
+		}
+	}
+#endif
+	FILE* fp = NULL;
+	fp = fopen(filepath, "w");
+	if (fp == NULL)
+	{
+
+		char msg[512];
+		snprintf(msg, sizeof msg, "Failed to create or open file %s", filepath);
+		JSON_MESSAGE(msg);
+		return -2;
+	}
+	int result = json_write_to(object, json_sink_file, fp, format);
+	if (fclose(fp))
+		result = -1;
+	return result ? -3 : 0;
+}
+
+// The contents of a file, either mapped or read into memory
+struct JSONFile
+{
+	char* data;
+	size_t size;
+	// The data is mapped with mmap instead of allocated
+	int mapped;
+};
+
+// Reads a whole file into a zero terminated buffer allocated with JSON_MALLOC
+// Returns NULL if the file could not be read
+static char* json_readfile(const char* filepath, size_t* size)
+{
+	FILE* fp;
+	fp = fopen(filepath, "rb");
+	if (fp == NULL)
+	{
+		char msg[512];
+		snprintf(msg, sizeof msg, "Failed to open file %s", filepath);
+		JSON_MESSAGE(msg);
+		return NULL;
+	}
+
+	// Read the file into a string
+	char* buf = NULL;
+	fseek(fp, 0L, SEEK_END);
+	*size = ftell(fp);
+	buf = JSON_MALLOC(*size + 1);
+	fseek(fp, 0L, SEEK_SET);
+	*size = fread(buf, 1, *size, fp);
+	buf[*size] = '\0';
+	fclose(fp);
+	return buf;
+}
+
+// Opens the contents of a file for loading
+// With JSON_USE_POSIX, regular files are mapped instead of copied into memory. If writable, the mapped pages can be
+// written to without affecting the file
+// Returns 0 on success
+static int json_file_open(struct JSONFile* file, const char* filepath, int writable)
+{
+#if JSON_USE_POSIX
+	int fd = open(filepath, O_RDONLY);
+	if (fd >= 0)
+	{
+		struct stat st;
+		if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+		{
+			void* data = mmap(NULL, st.st_size, PROT_READ | (writable ? PROT_WRITE : 0), MAP_PRIVATE, fd, 0);
+			if (data != MAP_FAILED)
+			{
+#ifdef POSIX_MADV_SEQUENTIAL
+				// The file is parsed front to back
+				posix_madvise(data, st.st_size, POSIX_MADV_SEQUENTIAL);
+#endif
+				close(fd);
+				file->data = data;
+				file->size = st.st_size;
+				file->mapped = 1;
+				return 0;
+			}
+		}
+		close(fd);
+	}
+#endif
+	// Fall back to reading the file
+	file->data = json_readfile(filepath, &file->size);
+	file->mapped = 0;
+	return file->data == NULL;
+}
+
+static void json_file_close(struct JSONFile* file)
+{
+#if JSON_USE_POSIX
+	if (file->mapped)
+	{
+		munmap(file->data, file->size);
+		file->data = NULL;
+		return;
+	}
+#endif
+	JSON_FREE(file->data);
+	file->data = NULL;
+}
+
+// The state of loading a tree, which is built from the events of the parser
+struct JSONLoader
+{
+	// Allocates the tree, NULL to allocate with JSON_MALLOC
+	struct JSONArena* arena;
+	// Strings and names are unescaped in and point into the loaded string instead of being allocated
+	int insitu;
+	// Shares equal names of members in arena if not NULL, and is set to NULL once a name is copied instead
+	struct JSONKeys* keys;
+	// The names loaded while sharing
+	size_t names;
+	// The value loaded into when no object or array is open
+	JSON* root;
+	// The name of the next member
+	char* name;
+	// The children of the objects and arrays currently being loaded
+	// Children are collected here and copied into exactly sized children once their parent is closed
+	struct JSONLoaderItem* items;
+	size_t size;
+	size_t capacity;
+	// The objects and arrays currently being loaded
+	struct JSONLoaderFrame* frames;
+	size_t depth;
+	size_t frames_capacity;
+};
+
+struct JSONLoaderItem
+{
+	JSON* item;
+	// Name of an object's member, NULL for elements
+	char* name;
+};
+
+struct JSONLoaderFrame
+{
+	JSON* object;
+	// Where the children of object start in the loader's items
+	size_t base;
+	// The children of the last object closed at this depth, whose names and index the next one can share
+	struct JSONChildren* shape;
+};
+
+static char* json_load_root(JSON* root, char* str, char* end, struct JSONArena* arena, struct JSONKeys* keys,
+							int insitu, JSONError* error);
+
+JSON* json_loadfile(const char* filepath)
+{
+	struct JSONFile file;
+	if (json_file_open(&file, filepath, 0))
+		return NULL;
+
+	JSON* root = json_create_empty();
+	JSONError error;
+	if (root == NULL)
+		json_error_memory(&error);
+	if (root == NULL || json_load_root(root, file.data, file.data + file.size, NULL, NULL, 0, &error) == NULL)
+	{
+		char source[512];
+		snprintf(source, sizeof source, "File %s", filepath);
+		json_error_message(source, &error);
+		if (root)
+			json_destroy(root);
+		json_file_close(&file);
+		return NULL;
+	}
+	root->up.name = strduplicate(filepath);
+	root->flags |= JSON_FLAG_NAME;
+	json_file_close(&file);
+	return root;
+}
+
+JSON* json_loadstring(char* str)
+{
+	return json_loadbuffer(str, strlen(str));
+}
+
+JSON* json_loadbuffer(const char* buf, size_t len)
+{
+	JSONError error;
+	JSON* root = json_loadbuffer_error(buf, len, &error);
+	if (root == NULL)
+		json_error_message("String", &error);
+	return root;
+}
+
+JSON* json_loadbuffer_error(const char* buf, size_t len, JSONError* error)
+{
+	JSON* root = json_create_empty();
+	if (root == NULL)
+	{
+		json_error_memory(error);
+		return NULL;
+	}
+	// The buffer is only written to when loading in situ
+	if (json_load_root(root, (char*)buf, (char*)buf + len, NULL, NULL, 0, error) == NULL)
+	{
+		json_destroy(root);
+		return NULL;
+	}
+	return root;
+}
+
+struct JSONDoc
+{
+	// Owns all nodes, names, and strings of the document
+	struct JSONArena arena;
+	// The names shared by the members of the document
+	struct JSONKeys keys;
+	// The loaded file the document's strings point into, if owned by the document
+	struct JSONFile file;
+	JSON* root;
+};
+
+// Loads the string from str to end into a new document with the first chunk sized after the input
+static JSONDoc* json_doc_load(char* str, char* end, int insitu, JSONError* error)
+{
+	JSONDoc* doc = JSON_MALLOC(sizeof(JSONDoc));
+	if (doc == NULL)
+	{
+		JSON_MESSAGE("Failed to allocate memory for document");
+		json_error_memory(error);
+		return NULL;
+	}
+	// In situ the arena only holds the nodes and children
+	json_arena_init(&doc->arena, insitu ? (end - str) / 2 : end - str);
+	json_keys_init(&doc->keys, &doc->arena, JSON_INTERN_LIMIT);
+	doc->file.data = NULL;
+	doc->root = json_create_node(&doc->arena);
+	if (doc->root == NULL)
+		json_error_memory(error);
+	if (doc->root == NULL || json_load_root(doc->root, str, end, &doc->arena, &doc->keys, insitu, error) == NULL)
+	{
+		json_doc_destroy(doc);
+		return NULL;
+	}
+	return doc;
+}
+
+JSONDoc* json_doc_loadstring(char* str)
+{
+	return json_doc_loadbuffer(str, strlen(str));
+}
+
+JSONDoc* json_doc_loadbuffer(const char* buf, size_t len)
+{
+	JSONError error;
+	JSONDoc* doc = json_doc_load((char*)buf, (char*)buf + len, 0, &error);
+	if (doc == NULL)
+		json_error_message("String", &error);
+	return doc;
+}
+
+JSONDoc* json_doc_loadbuffer_error(const char* buf, size_t len, JSONError* error)
+{
+	return json_doc_load((char*)buf, (char*)buf + len, 0, error);
+}
+
+JSONDoc* json_doc_loadstring_insitu(char* str)
+{
+	JSONError error;
+	JSONDoc* doc = json_doc_load(str, str + strlen(str), 1, &error);
+	if (doc == NULL)
+		json_error_message("String", &error);
+	return doc;
+}
+
+JSONDoc* json_doc_loadfile(const char* filepath)
+{
+	// Mapped pages are only copied when a string in them is unescaped
+	struct JSONFile file;
+	if (json_file_open(&file, filepath, 1))
+		return NULL;
+
+	// The file contents are kept as the backing store of the strings
+	JSONError error;
+	JSONDoc* doc = json_doc_load(file.data, file.data + file.size, 1, &error);
+	if (doc == NULL)
+	{
+		json_file_close(&file);
+		char source[512];
+		snprintf(source, sizeof source, "File %s", filepath);
+		json_error_message(source, &error);
+		return NULL;
+	}
+
+	size_t lpath = strlen(filepath);
+	// The root keeps no name if there's no memory left for it
+	doc->root->up.name = json_arena_alloc(&doc->arena, lpath + 1);
+	if (doc->root->up.name)
+	{
+		doc->root->flags |= JSON_FLAG_NAME;
+		memcpy(doc->root->up.name, filepath, lpath + 1);
+	}
+	doc->file = file;
+	return doc;
+}
+
+JSON* json_doc_root(JSONDoc* doc)
+{
+	return doc->root;
+}
+
+const char* json_doc_key(JSONDoc* doc, const char* name)
+{
+	char* key = json_keys_find(&doc->keys, name, strlen(name), 0);
+	return key ? key : name;
+}
+
+void json_doc_destroy(JSONDoc* doc)
+{
+	JSON_FREE(doc->keys.entries);
+	json_arena_free(&doc->arena);
+	if (doc->file.data)
+		json_file_close(&doc->file);
+	JSON_FREE(doc);
+}
+
+char* json_load(JSON* object, char* str)
+{
+	JSONError error;
+	char* result = json_load_root(object, str, str + strlen(str), NULL, NULL, 0, &error);
+	if (result == NULL)
+		json_error_message("String", &error);
+	return result;
+}
+
+// Pushes a child of the object or array being loaded
+static int json_loader_push(struct JSONLoader* loader, JSON* item, char* name)
+{
+	if (loader->size == loader->capacity)
+	{
+		size_t capacity = loader->capacity ? loader->capacity * 2 : 64;
+		struct JSONLoaderItem* tmp = JSON_REALLOC(loader->items, capacity * sizeof(struct JSONLoaderItem));
+		if (tmp == NULL)
 		{
-			lval *= 2;
-			char* tmp = JSON_REALLOC(*out, lval);
-			if (tmp == NULL)
+			JSON_MESSAGE("Failed to allocate memory for loading");
+			return -1;
+		}
+		JSON_STATS_ALLOC(parser, capacity * sizeof(struct JSONLoaderItem));
+		loader->items = tmp;
+		loader->capacity = capacity;
+	}
+	loader->items[loader->size].item = item;
+	loader->items[loader->size].name = name;
+	loader->size++;
+	return 0;
+}
+
+// Moves the members into object if they have the same names in the same order as the last object closed at the same
+// depth, and shares the names and index of that shape instead of making its own
+// Returns 0 if the shape differs, and -1 if memory couldn't be allocated
+static int json_loader_shape(struct JSONLoader* loader, JSON* object, struct JSONLoaderItem* items, int count)
+{
+	struct JSONChildren* shape = loader->frames[loader->depth].shape;
+	if (shape == NULL || shape->length != count)
+		return 0;
+	for (int i = 0; i < count; i++)
+	{
+		if (shape->names[i] != items[i].name)
+			return 0;
+	}
+
+	// Only the items are allocated, like the children of an array
+	struct JSONChildren* children = json_children_create(loader->arena, JSON_TARRAY, count);
+	if (children == NULL)
+		return -1;
+	children->names = shape->names;
+	children->index = shape->index;
+	for (int i = 0; i < count; i++)
+	{
+		children->items[i] = items[i].item;
+		items[i].item->up.parent = object;
+		items[i].item->pos = i;
+	}
+	children->count = children->length = count;
+	object->val.children = children;
+	return 1;
+}
+
+// Moves the children pushed since base into object
+// Duplicate members replace the value of the first member with the same name
+// Returns -1 if memory couldn't be allocated, and the children are left to the loader
+static int json_loader_close(struct JSONLoader* loader, JSON* object, size_t base)
+{
+	int count = loader->size - base;
+	if (count == 0)
+	{
+		object->val.children = NULL;
+		return 0;
+	}
+
+	// While every name is shared, equal names are the same pointer and objects of the same shape are found by them
+	int shared = loader->keys != NULL;
+	struct JSONLoaderItem* items = loader->items + base;
+	int shaped = shared && object->type == JSON_TOBJECT ? json_loader_shape(loader, object, items, count) : 0;
+	if (shaped)
+	{
+		if (shaped > 0)
+			loader->size = base;
+		return shaped > 0 ? 0 : -1;
+	}
+
+	struct JSONChildren* children = json_children_create(loader->arena, object->type, count);
+	if (children == NULL)
+		return -1;
+	// Without memory for an index the members are searched instead
+	if (object->type == JSON_TOBJECT && count >= JSON_INDEX_THRESHOLD)
+		children->index = json_index_create(loader->arena, count);
+	loader->size = base;
+	for (int i = 0; i < count; i++)
+	{
+		JSON* item = items[i].item;
+		int slot = children->length;
+		if (object->type == JSON_TOBJECT)
+		{
+			unsigned int hash = 0;
+			int dup = -1;
+			if (children->index)
 			{
-				JSON_MESSAGE("Failed to allocate memory for string value");
-				return str;
+				hash = json_hash(items[i].name);
+				struct JSONIndexEntry* entry = json_index_find(children, items[i].name, hash);
+				dup = entry ? entry->slot : -1;
+			}
+			else if (shared)
+			{
+				for (int j = 0; j < slot; j++)
+				{
+					if (children->names[j] == items[i].name)
+					{
+						dup = j;
+						break;
+					}
+				}
+			}
+			else
+				dup = json_find_slot(children, items[i].name);
+
+			if (dup >= 0)
+			{
+				if (loader->arena == NULL)
+				{
+					json_destroy(children->items[dup]);
+					JSON_FREE(items[i].name);
+				}
+				slot = dup;
+			}
+			else
+			{
+				children->names[slot] = items[i].name;
+				if (children->index)
+					json_index_put(children->index, slot, hash);
+				children->length++;
 			}
-			*out = tmp;
-			result = *out;
 		}
+		else
+			children->length++;
 
-		// Escape sequence
-		if (c == '\\')
+		children->items[slot] = item;
+		item->up.parent = object;
+		item->pos = slot;
+	}
+	children->count = children->length;
+	object->val.children = children;
+	if (shared && object->type == JSON_TOBJECT)
+		loader->frames[loader->depth].shape = children;
+	return 0;
+}
+
+// Creates the node of the next value and pushes it as a child of the innermost object or array
+// The first value is loaded into the root instead
+static JSON* json_loader_value(struct JSONLoader* loader, int type)
+{
+	JSON* node = loader->root;
+	if (loader->depth > 0)
+	{
+		node = json_create_node(loader->arena);
+		if (node == NULL)
+			return NULL;
+		// The name is owned by the pushed member from here
+		char* name = loader->name;
+		loader->name = NULL;
+		if (json_loader_push(loader, node, name))
 		{
-			switch (str[1])
+			if (loader->arena == NULL)
 			{
-			case '"':
-				result[valit++] = '"';
-				break;
-			case '\\':
-				result[valit++] = '\\';
-				break;
-			case '/':
-				result[valit++] = '/';
-				break;
-			case 'b':
-				result[valit++] = '\b';
-				break;
-			case 'f':
-				result[valit++] = '\f';
-				break;
-			case 'n':
-				result[valit++] = '\n';
-				break;
-			case 'r':
-				result[valit++] = '\r';
-				break;
-			case 't':
-				result[valit++] = '\t';
-				break;
-			default:
-				JSON_MESSAGE("Invalid escape sequence");
-				break;
+				JSON_FREE(node);
+				JSON_FREE(name);
 			}
-			str++;
+			return NULL;
+		}
+	}
+	node->type = type;
+	return node;
+}
+
+// Returns the string to store, which is str itself in situ or a zero terminated copy
+static char* json_loader_string(struct JSONLoader* loader, const char* str, size_t len)
+{
+	if (loader->insitu)
+		return (char*)str;
+	char* copy = json_alloc(loader->arena, len + 1);
+	if (copy == NULL)
+	{
+		JSON_MESSAGE("Failed to allocate memory for string value");
+		return NULL;
+	}
+	memcpy(copy, str, len);
+	copy[len] = '\0';
+	return copy;
+}
+
+// Opens an object or array whose children are pushed until it's closed
+static int json_loader_open(struct JSONLoader* loader, int type)
+{
+	if (loader->depth == loader->frames_capacity)
+	{
+		size_t capacity = loader->frames_capacity ? loader->frames_capacity * 2 : 32;
+		struct JSONLoaderFrame* tmp = JSON_REALLOC(loader->frames, capacity * sizeof(struct JSONLoaderFrame));
+		if (tmp == NULL)
+		{
+			JSON_MESSAGE("Failed to allocate memory for loading");
+			return -1;
+		}
+		JSON_STATS_ALLOC(parser, capacity * sizeof(struct JSONLoaderFrame));
+		for (size_t i = loader->frames_capacity; i < capacity; i++)
+			tmp[i].shape = NULL;
+		loader->frames = tmp;
+		loader->frames_capacity = capacity;
+	}
+	JSON* node = json_loader_value(loader, type);
+	if (node == NULL)
+		return -1;
+	loader->frames[loader->depth].object = node;
+	loader->frames[loader->depth].base = loader->size;
+	loader->depth++;
+	return 0;
+}
+
+// The handler building the tree
+static int json_loader_start_object(void* ctx)
+{
+	return json_loader_open(ctx, JSON_TOBJECT);
+}
+
+static int json_loader_start_array(void* ctx)
+{
+	return json_loader_open(ctx, JSON_TARRAY);
+}
+
+static int json_loader_end(void* ctx)
+{
+	struct JSONLoader* loader = ctx;
+	loader->depth--;
+	return json_loader_close(loader, loader->frames[loader->depth].object, loader->frames[loader->depth].base);
+}
+
+static int json_loader_key(void* ctx, const char* name, size_t len)
+{
+	struct JSONLoader* loader = ctx;
+	if (loader->keys)
+	{
+		loader->name = json_keys_find(loader->keys, name, len, 1);
+		// Names that are mostly distinct, like those of an object used as a map, aren't worth looking up
+		if (++loader->names >= JSON_KEYS_SAMPLE && loader->keys->count * 2 > loader->names)
+			loader->keys = NULL;
+		if (loader->name)
+			return 0;
+		// The table is full, further names are copied
+		loader->keys = NULL;
+	}
+	loader->name = json_loader_string(loader, name, len);
+	if (loader->name == NULL)
+		return -1;
+	if (!loader->insitu)
+		JSON_STATS_ALLOC(names, len + 1);
+	return 0;
+}
+
+static int json_loader_string_value(void* ctx, const char* str, size_t len)
+{
+	struct JSONLoader* loader = ctx;
+	char* copy = json_loader_string(loader, str, len);
+	if (copy == NULL)
+		return -1;
+	if (!loader->insitu)
+		JSON_STATS_ALLOC(strings, len + 1);
+	JSON* node = json_loader_value(loader, JSON_TSTRING);
+	if (node == NULL)
+	{
+		if (loader->arena == NULL)
+			JSON_FREE(copy);
+		return -1;
+	}
+	node->val.stringval = copy;
+	return 0;
+}
+
+static int json_loader_number(void* ctx, double num)
+{
+	JSON* node = json_loader_value(ctx, JSON_TNUMBER);
+	if (node == NULL)
+		return -1;
+	node->val.numval = num;
+	return 0;
+}
+
+static int json_loader_integer(void* ctx, int64_t num)
+{
+	JSON* node = json_loader_value(ctx, JSON_TNUMBER);
+	if (node == NULL)
+		return -1;
+	node->flags |= JSON_FLAG_INTEGER;
+	node->val.intval = num;
+	return 0;
+}
+
+static int json_loader_boolean(void* ctx, int val)
+{
+	JSON* node = json_loader_value(ctx, JSON_TBOOL);
+	if (node == NULL)
+		return -1;
+	node->val.numval = val;
+	return 0;
+}
+
+static int json_loader_null(void* ctx)
+{
+	return json_loader_value(ctx, JSON_TNULL) == NULL;
+}
+
+static const JSONHandler json_loader_handler = {
+	.start_object = json_loader_start_object,
+	.end_object = json_loader_end,
+	.start_array = json_loader_start_array,
+	.end_array = json_loader_end,
+	.key = json_loader_key,
+	.string = json_loader_string_value,
+	.number = json_loader_number,
+	.integer = json_loader_integer,
+	.boolean = json_loader_boolean,
+	.null = json_loader_null,
+};
+
+// Frees the memory used while loading
+// If loading failed, the children of objects and arrays that were never closed are freed too
+static void json_loader_free(struct JSONLoader* loader, int failed)
+{
+	if (failed && loader->arena == NULL)
+	{
+		for (size_t i = 0; i < loader->size; i++)
+		{
+			json_destroy(loader->items[i].item);
+			JSON_FREE(loader->items[i].name);
+		}
+		JSON_FREE(loader->name);
+	}
+	JSON_FREE(loader->items);
+	JSON_FREE(loader->frames);
+}
+
+// Loads the string from str to end into root with a loader and a parser passing its events to the loader
+// Parsing starts over, so both can be reused for several loads and keep the memory they allocated
+static char* json_loader_run(struct JSONParser* parser, struct JSONLoader* loader, JSON* root, char* str, char* end)
+{
+	root->type = JSON_TINVALID;
+	root->flags &= ~JSON_FLAG_INTEGER;
+	root->val.numval = 0;
+
+	loader->root = root;
+	loader->name = NULL;
+	loader->size = 0;
+	loader->depth = 0;
+	parser->end = end;
+	parser->state = JSON_PARSE_VALUE;
+	parser->depth = 0;
+	parser->error = JSON_ERROR_NONE;
+	return json_parse_internal(parser, str);
+}
+
+// Loads the string from str to end into root
+// All allocations are made from arena, or with JSON_MALLOC if it is NULL
+// If the string is invalid, error is set to why and where unless it is NULL
+static char* json_load_root(JSON* root, char* str, char* end, struct JSONArena* arena, struct JSONKeys* keys,
+							int insitu, JSONError* error)
+{
+	struct JSONLoader loader = {.arena = arena, .insitu = insitu, .keys = keys};
+	struct JSONParser parser = {.handler = &json_loader_handler, .ctx = &loader, .insitu = insitu, .start = str};
+	char* result = json_loader_run(&parser, &loader, root, str, end);
+	if (result == NULL && error)
+	{
+		json_parser_report(&parser, error);
+		// The loader only stops parsing when memory couldn't be allocated
+		if (error->code == JSON_ERROR_STOPPED)
+			error->code = JSON_ERROR_MEMORY;
+	}
+	json_loader_free(&loader, result == NULL);
+	JSON_FREE(parser.scratch);
+	JSON_FREE(parser.stack);
+	return result;
+}
+
+JSONParser* json_parser_create(const JSONHandler* handler, void* ctx)
+{
+	struct JSONParser* parser = JSON_MALLOC(sizeof(struct JSONParser));
+	if (parser == NULL)
+	{
+		JSON_MESSAGE("Failed to allocate memory for parser");
+		return NULL;
+	}
+	*parser = (struct JSONParser){.handler = handler, .ctx = ctx, .more = 1};
+
+	// Build a tree from the events
+	if (handler == NULL)
+	{
+		struct JSONLoader* loader = JSON_MALLOC(sizeof(struct JSONLoader));
+		JSON* root = json_create_empty();
+		if (loader == NULL || root == NULL)
+		{
+			JSON_MESSAGE("Failed to allocate memory for parser");
+			JSON_FREE(loader);
+			JSON_FREE(root);
+			JSON_FREE(parser);
+			return NULL;
+		}
+		*loader = (struct JSONLoader){.root = root};
+		parser->handler = &json_loader_handler;
+		parser->ctx = loader;
+		parser->loader = loader;
+	}
+	return parser;
+}
+
+// Appends len characters to the token carried over to the next chunk
+// Returns 0 if memory couldn't be allocated
+static int json_parser_carry(struct JSONParser* parser, const char* str, size_t len)
+{
+	if (len == 0)
+		return 1;
+	if (parser->carry_len + len > parser->carry_capacity)
+	{
+		size_t capacity = parser->carry_capacity ? parser->carry_capacity * 2 : 64;
+		while (capacity < parser->carry_len + len)
+			capacity *= 2;
+		char* tmp = JSON_REALLOC(parser->carry, capacity);
+		if (tmp == NULL)
+		{
+			JSON_MESSAGE("Failed to allocate memory for parsing");
+			return 0;
+		}
+		JSON_STATS_ALLOC(parser, capacity);
+		parser->carry = tmp;
+		parser->carry_capacity = capacity;
+	}
+	// The cut off token may itself be the end of the carry when a completed one is parsed
+	memmove(parser->carry + parser->carry_len, str, len);
+	parser->carry_len += len;
+	return 1;
+}
+
+// Returns how many characters at the start of str belong to the carried token, and sets complete if the token ends
+// within len characters. The character after a number or literal is included, since only it tells that the token
+// ended
+static size_t json_parser_token_end(struct JSONParser* parser, const char* str, size_t len, int* complete)
+{
+	*complete = 1;
+	if (parser->carry[0] == '"')
+	{
+		for (size_t i = 0; i < len; i++)
+		{
+			if (parser->carry_escape)
+				parser->carry_escape = 0;
+			else if (str[i] == '\\')
+				parser->carry_escape = 1;
+			else if (str[i] == '"')
+				return i + 1;
+		}
+	}
+	else
+	{
+		for (size_t i = 0; i < len; i++)
+		{
+			char c = str[i];
+			if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '-' ||
+				  c == '+' || c == '.'))
+				return i + 1;
+		}
+	}
+	*complete = 0;
+	return len;
+}
+
+// Parses str to end in the parser's state and carries a token cut off at end over to the next chunk
+// offset is where str starts in the whole input
+// Returns 0 on success, -1 if the json is invalid, and -2 if a callback stopped parsing
+static int json_parser_run(struct JSONParser* parser, char* str, char* end, size_t offset)
+{
+	parser->end = end;
+	parser->start = str;
+	parser->offset = offset;
+	parser->incomplete = 0;
+	char* result = json_parse_internal(parser, str);
+	if (result && parser->incomplete)
+	{
+		// Find whether the carried string ends inside an escape sequence
+		parser->carry_escape = 0;
+		if (result < end && *result == '"')
+			for (char* p = result + 1; p < end; p++)
+				parser->carry_escape = !parser->carry_escape && *p == '\\';
+		parser->carry_offset = offset + (result - str);
+		if (json_parser_carry(parser, result, end - result))
+			return 0;
+		result = json_parser_fail(parser, JSON_ERROR_MEMORY, result);
+	}
+	else if (result && result != end)
+		result = json_parser_fail(parser, JSON_ERROR_TRAILING, result);
+	if (result == NULL)
+	{
+		parser->failed = 1;
+		return parser->error == JSON_ERROR_STOPPED ? -2 : -1;
+	}
+	return 0;
+}
+
+int json_parser_feed(JSONParser* parser, const char* buf, size_t len)
+{
+	if (parser->failed || parser->finished)
+		return -1;
+
+	// The chunk is never written to
+	char* str = (char*)buf;
+	size_t offset = parser->fed;
+	parser->fed += len;
+
+	// Complete the token cut off by the previous chunk and parse it from the carry
+	if (parser->carry_len)
+	{
+		int complete;
+		size_t used = json_parser_token_end(parser, str, len, &complete);
+		if (!json_parser_carry(parser, str, used))
+		{
+			parser->start = str;
+			parser->offset = offset;
+			json_parser_fail(parser, JSON_ERROR_MEMORY, str);
+			parser->failed = 1;
+			return -1;
+		}
+		if (!complete)
+			return 0;
+		str += used;
+		len -= used;
+		size_t carry_len = parser->carry_len;
+		parser->carry_len = 0;
+		int result = json_parser_run(parser, parser->carry, parser->carry + carry_len, parser->carry_offset);
+		if (result)
+			return result;
+	}
+
+	return json_parser_run(parser, str, str + len, offset + (str - buf));
+}
+
+int json_parser_finish(JSONParser* parser)
+{
+	if (parser->failed || parser->finished)
+		return -1;
+	// The end of the input ends the carried token, and anything still open is an error
+	parser->more = 0;
+	char* str = parser->carry ? parser->carry : (char*)"";
+	size_t carry_len = parser->carry_len;
+	parser->carry_len = 0;
+	int result = json_parser_run(parser, str, str + carry_len, carry_len ? parser->carry_offset : parser->fed);
+	if (result == 0)
+		parser->finished = 1;
+	return result;
+}
+
+JSON* json_parser_root(JSONParser* parser)
+{
+	if (parser->loader == NULL || !parser->finished)
+		return NULL;
+	JSON* root = parser->loader->root;
+	parser->loader->root = NULL;
+	return root;
+}
+
+void json_parser_error(JSONParser* parser, JSONError* error)
+{
+	*error = (JSONError){parser->error, 0, 0, 0};
+	if (parser->error == JSON_ERROR_NONE)
+		return;
+	error->offset = parser->offset + (parser->error_at - parser->start);
+	// A parser building a tree only stops when memory couldn't be allocated
+	if (parser->loader && error->code == JSON_ERROR_STOPPED)
+		error->code = JSON_ERROR_MEMORY;
+}
+
+void json_parser_destroy(JSONParser* parser)
+{
+	if (parser->loader)
+	{
+		json_loader_free(parser->loader, !parser->finished);
+		if (parser->loader->root)
+			json_destroy(parser->loader->root);
+		JSON_FREE(parser->loader);
+	}
+	JSON_FREE(parser->carry);
+	JSON_FREE(parser->scratch);
+	JSON_FREE(parser->stack);
+	JSON_FREE(parser);
+}
+
+struct JSONLines
+{
+	// Owns the nodes, names, and strings of the current record, emptied before loading the next
+	struct JSONArena arena;
+	// The file the records are read from, if owned by the reader
+	struct JSONFile file;
+	// The start of the buffer or file, and the records not read yet
+	char* begin;
+	char* str;
+	char* end;
+	// The line number of the current record
+	size_t line;
+	// Reused for every record so that their memory is only allocated once
+	struct JSONParser parser;
+	struct JSONLoader loader;
+};
+
+// Creates a reader of the records from str to end
+static JSONLines* json_lines_open(char* str, char* end, int insitu)
+{
+	JSONLines* lines = JSON_MALLOC(sizeof(JSONLines));
+	if (lines == NULL)
+	{
+		JSON_MESSAGE("Failed to allocate memory for reader");
+		return NULL;
+	}
+	json_arena_init(&lines->arena, 0);
+	lines->file.data = NULL;
+	lines->begin = str;
+	lines->str = str;
+	lines->end = end;
+	lines->line = 0;
+	lines->loader = (struct JSONLoader){.arena = &lines->arena, .insitu = insitu};
+	lines->parser =
+		(struct JSONParser){.handler = &json_loader_handler, .ctx = &lines->loader, .insitu = insitu};
+	return lines;
+}
+
+JSONLines* json_lines_openbuffer(const char* buf, size_t len)
+{
+	// The buffer is only written to when loading in situ
+	return json_lines_open((char*)buf, (char*)buf + len, 0);
+}
+
+JSONLines* json_lines_openfile(const char* filepath)
+{
+	// Mapped pages are only copied when a string in them is unescaped
+	struct JSONFile file;
+	if (json_file_open(&file, filepath, 1))
+		return NULL;
+	JSONLines* lines = json_lines_open(file.data, file.data + file.size, 1);
+	if (lines == NULL)
+	{
+		json_file_close(&file);
+		return NULL;
+	}
+	lines->file = file;
+	return lines;
+}
+
+// Loads the next record of newline delimited json from *str to end into a node allocated from the loader's arena
+// Blank lines are skipped. *str is moved past the line of the record and line is counted up for every line read
+// Returns 1 if a record was read, 0 at the end, and -1 if the line is invalid
+static int json_lines_load(struct JSONParser* parser, struct JSONLoader* loader, char** str, char* end, size_t* line,
+						   JSON** record)
+{
+	*record = NULL;
+	while (*str < end)
+	{
+		// Strings can't contain a raw newline, so every newline ends a record
+		// Errors are located from the start of the line, which is enough to give their column
+		char* p = *str;
+		parser->start = p;
+		char* line_end = memchr(p, '\n', end - p);
+		if (line_end == NULL)
+			line_end = end;
+		*str = line_end < end ? line_end + 1 : line_end;
+		(*line)++;
+
+		// Skip blank lines
+		while (p < line_end && JSON_IS_WHITESPACE(*p))
+			p++;
+		if (p == line_end)
 			continue;
+
+		JSON* root = json_create_node(loader->arena);
+		if (root == NULL)
+		{
+			json_parser_fail(parser, JSON_ERROR_MEMORY, p);
+			return -1;
 		}
+		char* result = json_loader_run(parser, loader, root, p, line_end);
+		if (result && result != line_end)
+			result = json_parser_fail(parser, JSON_ERROR_TRAILING, result);
+		if (result == NULL)
+			return -1;
+		*record = root;
+		return 1;
+	}
+	return 0;
+}
+
+int json_lines_next(JSONLines* lines, JSON** record)
+{
+	json_arena_reset(&lines->arena);
+	return json_lines_load(&lines->parser, &lines->loader, &lines->str, lines->end, &lines->line, record);
+}
+
+size_t json_lines_line(JSONLines* lines)
+{
+	return lines->line;
+}
 
-		if (c == '\\' || c == '\b' || c == '\f' || c == '\n' || c == '\r' || c == '\t')
-		{
-			char msg[512];
-			snprintf(msg, sizeof msg, "Invalid character in string %10s, control characters must be escaped", str);
-			JSON_MESSAGE(msg);
-			return NULL;
-		}
+void json_lines_error(JSONLines* lines, JSONError* error)
+{
+	json_parser_report(&lines->parser, error);
+	error->offset += lines->parser.start - lines->begin;
+	error->line = lines->line;
+	// The loader only stops parsing when memory couldn't be allocated
+	if (error->code == JSON_ERROR_STOPPED)
+		error->code = JSON_ERROR_MEMORY;
+}
 
-		// End quote
-		if (c == '"')
-		{
-			result[valit++] = '\0';
-			return str + 1;
-		}
+void json_lines_close(JSONLines* lines)
+{
+	json_loader_free(&lines->loader, 0);
+	JSON_FREE(lines->parser.scratch);
+	JSON_FREE(lines->parser.stack);
+	json_arena_free(&lines->arena);
+	if (lines->file.data)
+		json_file_close(&lines->file);
+	JSON_FREE(lines);
+}
+
+struct JSONLinesWriter
+{
+	// Holds the records until the buffer is full and is kept between records
+	struct JSONStringStream ss;
+};
 
-		// Normal character
-		result[valit++] = c;
+JSONLinesWriter* json_lines_writer_create(JSONWriteFn write, void* ctx)
+{
+	JSONLinesWriter* writer = JSON_MALLOC(sizeof(JSONLinesWriter));
+	char* buf = JSON_MALLOC(JSON_WRITE_BUFFER);
+	if (writer == NULL || buf == NULL)
+	{
+		JSON_MESSAGE("Failed to allocate memory for string stream");
+		JSON_FREE(writer);
+		JSON_FREE(buf);
+		return NULL;
 	}
-	JSON_MESSAGE("Unexpected end of string");
-	return str;
+	JSON_STATS_ALLOC(writer, JSON_WRITE_BUFFER);
+	writer->ss = (struct JSONStringStream){.str = buf, .size = JSON_WRITE_BUFFER, .write = write, .ctx = ctx};
+	return writer;
 }
 
-struct JSON
+int json_lines_write(JSONLinesWriter* writer, JSON* record)
 {
-	int type;
+	json_tostring_internal(record, &writer->ss, JSON_COMPACT, 0);
+	json_ss_literal(&writer->ss, "\n");
+	return writer->ss.failed ? -1 : 0;
+}
 
-	char* name;
-	char* stringval;
-	double numval;
-	struct JSON* members;
-	int count;
-	// Linked list to the other members
-	// First elements are more recent
-	struct JSON *prev, *next;
+int json_lines_writer_close(JSONLinesWriter* writer)
+{
+	if (!writer->ss.failed && writer->ss.length)
+		json_ss_flush(&writer->ss);
+	int result = writer->ss.failed ? -1 : 0;
+	JSON_FREE(writer->ss.str);
+	JSON_FREE(writer);
+	return result;
+}
+
+// A lock shared by threads, which does nothing without threads
+struct JSONMutex
+{
+#if JSON_USE_POSIX
+	pthread_mutex_t mutex;
+#elif JSON_USE_WINAPI
+	CRITICAL_SECTION section;
+#else
+	int unused;
+#endif
 };
 
-// Constructors
-JSON* json_create_empty()
+static void json_mutex_init(struct JSONMutex* mutex)
 {
-	JSON* object = JSON_MALLOC(sizeof(JSON));
-	object->type = JSON_TINVALID;
-	object->name = NULL;
-	object->stringval = NULL;
-	object->numval = 0;
-	object->members = NULL;
-	object->count = 0;
-	object->prev = NULL;
-	object->next = NULL;
-	return object;
+#if JSON_USE_POSIX
+	pthread_mutex_init(&mutex->mutex, NULL);
+#elif JSON_USE_WINAPI
+	InitializeCriticalSection(&mutex->section);
+#endif
+	(void)mutex;
 }
-JSON* json_create_null()
+
+static void json_mutex_lock(struct JSONMutex* mutex)
 {
-	JSON* object = json_create_empty();
-	object->type = JSON_TNULL;
-	return object;
+#if JSON_USE_POSIX
+	pthread_mutex_lock(&mutex->mutex);
+#elif JSON_USE_WINAPI
+	EnterCriticalSection(&mutex->section);
+#endif
+	(void)mutex;
 }
 
-JSON* json_create_string(const char* str)
+static void json_mutex_unlock(struct JSONMutex* mutex)
 {
-	JSON* object = json_create_empty();
-	object->type = JSON_TSTRING;
-	object->stringval = strduplicate(str);
-	return object;
+#if JSON_USE_POSIX
+	pthread_mutex_unlock(&mutex->mutex);
+#elif JSON_USE_WINAPI
+	LeaveCriticalSection(&mutex->section);
+#endif
+	(void)mutex;
 }
 
-JSON* json_create_number(double value)
+static void json_mutex_destroy(struct JSONMutex* mutex)
 {
-	JSON* object = json_create_empty();
-	object->type = JSON_TNUMBER;
-	object->numval = value;
-	return object;
+#if JSON_USE_POSIX
+	pthread_mutex_destroy(&mutex->mutex);
+#elif JSON_USE_WINAPI
+	DeleteCriticalSection(&mutex->section);
+#endif
+	(void)mutex;
 }
 
-JSON* json_create_object()
+// The work of one thread started by json_threads_run
+struct JSONThread
 {
-	JSON* object = json_create_empty();
-	object->type = JSON_TOBJECT;
-	return object;
+	void (*work)(void* ctx);
+	void* ctx;
+#if JSON_USE_POSIX
+	pthread_t thread;
+#elif JSON_USE_WINAPI
+	HANDLE thread;
+#endif
+};
+
+#if JSON_USE_POSIX
+static void* json_thread_start(void* thread)
+{
+	((struct JSONThread*)thread)->work(((struct JSONThread*)thread)->ctx);
+	return NULL;
+}
+#elif JSON_USE_WINAPI
+static DWORD WINAPI json_thread_start(LPVOID thread)
+{
+	((struct JSONThread*)thread)->work(((struct JSONThread*)thread)->ctx);
+	return 0;
 }
+#endif
 
-JSON* json_create_array()
+// Returns the number of threads to use for count, where 0 means one per processor
+// Always 1 without JSON_USE_POSIX or JSON_USE_WINAPI
+static int json_threads_count(int count)
 {
-	JSON* object = json_create_empty();
-	object->type = JSON_TARRAY;
-	return object;
+#if JSON_USE_POSIX
+	if (count <= 0)
+		count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#elif JSON_USE_WINAPI
+	if (count <= 0)
+	{
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		count = (int)info.dwNumberOfProcessors;
+	}
+#else
+	count = 1;
+#endif
+	return count > 0 ? count : 1;
 }
 
-void json_set_invalid(JSON* object)
+// Calls work with each of count contexts of size bytes on its own thread and waits for all of them
+// The calling thread does the work of the first context. If a thread can't be started its work is done on the calling
+// thread too
+static void json_threads_run(void (*work)(void* ctx), void* contexts, size_t size, int count)
 {
-	// If previous type was object or array, destroy members
-	if (object->members)
+	struct JSONThread* threads = count > 1 ? JSON_MALLOC(count * sizeof(struct JSONThread)) : NULL;
+	int started = 1;
+#if JSON_USE_POSIX || JSON_USE_WINAPI
+	for (; threads && started < count; started++)
 	{
-		JSON* cur = object->members;
-		while (cur)
-		{
-			JSON* next = cur->next;
-			json_destroy(cur);
-			cur = next;
-		}
+		threads[started].work = work;
+		threads[started].ctx = (char*)contexts + started * size;
+#if JSON_USE_POSIX
+		if (pthread_create(&threads[started].thread, NULL, json_thread_start, &threads[started]))
+			break;
+#else
+		threads[started].thread = CreateThread(NULL, 0, json_thread_start, &threads[started], 0, NULL);
+		if (threads[started].thread == NULL)
+			break;
+#endif
 	}
-	object->count = 0;
-	object->members = NULL;
-	if (object->stringval)
+#endif
+	if (threads == NULL)
+		started = 1;
+
+	work(contexts);
+	for (int i = started; i < count; i++)
+		work((char*)contexts + i * size);
+
+	for (int i = 1; i < started; i++)
 	{
-		JSON_FREE(object->stringval);
+#if JSON_USE_POSIX
+		pthread_join(threads[i].thread, NULL);
+#elif JSON_USE_WINAPI
+		WaitForSingleObject(threads[i].thread, INFINITE);
+		CloseHandle(threads[i].thread);
+#endif
 	}
-	object->type = JSON_TINVALID;
-	object->numval = 0;
+	JSON_FREE(threads);
 }
 
-// Setters
-void json_set_string(JSON* object, const char* str)
+// The records of a part of a batch's input, loaded by one worker
+struct JSONBatchChunk
 {
-	json_set_invalid(object);
-	object->type = JSON_TSTRING;
-	object->stringval = strduplicate(str);
-}
+	char* str;
+	char* end;
+	JSON** records;
+	size_t count;
+	size_t capacity;
+	// Set if memory couldn't be allocated
+	int failed;
+};
 
-void json_set_number(JSON* object, double num)
+// A thread loading chunks of a batch into its own arena
+struct JSONBatchWorker
 {
-	json_set_invalid(object);
-	object->type = JSON_TNUMBER;
-	object->numval = num;
-}
+	struct JSONBatch* batch;
+	// Owns the nodes, names, and strings of the records loaded by the worker
+	struct JSONArena arena;
+};
 
-void json_set_bool(JSON* object, int val)
+struct JSONBatch
 {
-	json_set_invalid(object);
-	object->type = JSON_TBOOL;
-	object->numval = val;
-}
+	// The file the records are read from, if owned by the batch
+	struct JSONFile file;
+	int insitu;
+	// The input split on line boundaries, taken in order by the workers
+	struct JSONBatchChunk* chunks;
+	size_t chunk_count;
+	size_t next_chunk;
+	struct JSONMutex lock;
+	struct JSONBatchWorker* workers;
+	int worker_count;
+	// The records of all chunks in input order
+	JSON** records;
+	size_t count;
+};
 
-void json_set_null(JSON* object)
+// Loads chunks of the batch until none are left, with a parser and loader kept for all of the worker's records
+static void json_batch_work(void* ctx)
 {
-	json_set_invalid(object);
-	object->type = JSON_TNULL;
+	struct JSONBatchWorker* worker = ctx;
+	struct JSONBatch* batch = worker->batch;
+	// The records of a worker share their names
+	struct JSONKeys keys;
+	json_keys_init(&keys, &worker->arena, JSON_INTERN_LIMIT);
+	struct JSONLoader loader = {.arena = &worker->arena, .insitu = batch->insitu, .keys = &keys};
+	struct JSONParser parser = {.handler = &json_loader_handler, .ctx = &loader, .insitu = batch->insitu};
+	for (;;)
+	{
+		json_mutex_lock(&batch->lock);
+		size_t index = batch->next_chunk < batch->chunk_count ? batch->next_chunk++ : batch->chunk_count;
+		json_mutex_unlock(&batch->lock);
+		if (index == batch->chunk_count)
+			break;
+
+		struct JSONBatchChunk* chunk = &batch->chunks[index];
+		size_t line = 0;
+		JSON* record;
+		while (json_lines_load(&parser, &loader, &chunk->str, chunk->end, &line, &record) != 0)
+		{
+			if (chunk->count == chunk->capacity)
+			{
+				size_t capacity = chunk->capacity ? chunk->capacity * 2 : 64;
+				JSON** tmp = JSON_REALLOC(chunk->records, capacity * sizeof(JSON*));
+				if (tmp == NULL)
+				{
+					JSON_MESSAGE("Failed to allocate memory for batch");
+					chunk->failed = 1;
+					break;
+				}
+				chunk->records = tmp;
+				chunk->capacity = capacity;
+			}
+			// Invalid lines keep their place as NULL
+			chunk->records[chunk->count++] = record;
+		}
+	}
+	json_loader_free(&loader, 0);
+	JSON_FREE(keys.entries);
+	JSON_FREE(parser.scratch);
+	JSON_FREE(parser.stack);
 }
 
-const char* json_get_name(JSON* object)
+// Loads the records from str to end on threads workers, including the calling thread
+static JSONBatch* json_batch_load(char* str, char* end, int insitu, int threads)
 {
-	return object->name;
+	JSONBatch* batch = JSON_MALLOC(sizeof(JSONBatch));
+	if (batch == NULL)
+	{
+		JSON_MESSAGE("Failed to allocate memory for batch");
+		return NULL;
+	}
+	batch->file.data = NULL;
+	batch->insitu = insitu;
+	batch->next_chunk = 0;
+	batch->records = NULL;
+	batch->count = 0;
+
+	// Split the input into chunks ending after a newline
+	size_t chunk_count = (end - str) / JSON_BATCH_CHUNK + 1;
+	batch->chunks = JSON_MALLOC(chunk_count * sizeof(struct JSONBatchChunk));
+	batch->chunk_count = 0;
+	while (batch->chunks && str < end)
+	{
+		char* chunk_end = end - str > JSON_BATCH_CHUNK ? str + JSON_BATCH_CHUNK : end;
+		char* newline = memchr(chunk_end - 1, '\n', end - chunk_end + 1);
+		chunk_end = newline ? newline + 1 : end;
+		batch->chunks[batch->chunk_count++] = (struct JSONBatchChunk){str, chunk_end, NULL, 0, 0, 0};
+		str = chunk_end;
+	}
+
+	threads = json_threads_count(threads);
+	if ((size_t)threads > batch->chunk_count)
+		threads = batch->chunk_count ? (int)batch->chunk_count : 1;
+	batch->workers = JSON_MALLOC(threads * sizeof(struct JSONBatchWorker));
+	batch->worker_count = 0;
+	if (batch->chunks == NULL || batch->workers == NULL)
+	{
+		JSON_MESSAGE("Failed to allocate memory for batch");
+		json_batch_destroy(batch);
+		return NULL;
+	}
+	for (int i = 0; i < threads; i++)
+	{
+		batch->workers[i].batch = batch;
+		json_arena_init(&batch->workers[i].arena, 0);
+	}
+	batch->worker_count = threads;
+
+	json_mutex_init(&batch->lock);
+	json_threads_run(json_batch_work, batch->workers, sizeof(struct JSONBatchWorker), threads);
+	json_mutex_destroy(&batch->lock);
+
+	// Gather the records in input order
+	size_t count = 0;
+	int failed = 0;
+	for (size_t i = 0; i < batch->chunk_count; i++)
+	{
+		count += batch->chunks[i].count;
+		failed |= batch->chunks[i].failed;
+	}
+	batch->records = failed ? NULL : JSON_MALLOC((count ? count : 1) * sizeof(JSON*));
+	if (batch->records == NULL)
+	{
+		JSON_MESSAGE("Failed to allocate memory for batch");
+		json_batch_destroy(batch);
+		return NULL;
+	}
+	for (size_t i = 0; i < batch->chunk_count; i++)
+	{
+		if (batch->chunks[i].count)
+			memcpy(batch->records + batch->count, batch->chunks[i].records, batch->chunks[i].count * sizeof(JSON*));
+		batch->count += batch->chunks[i].count;
+		JSON_FREE(batch->chunks[i].records);
+	}
+	JSON_FREE(batch->chunks);
+	batch->chunks = NULL;
+	batch->chunk_count = 0;
+	return batch;
 }
 
-int json_get_type(JSON* object)
+JSONBatch* json_batch_loadbuffer(const char* buf, size_t len, int threads)
 {
-	return object->type;
+	// The buffer is only written to when loading in situ
+	return json_batch_load((char*)buf, (char*)buf + len, 0, threads);
 }
 
-char* json_get_string(JSON* object)
+JSONBatch* json_batch_loadfile(const char* filepath, int threads)
 {
-	return object->stringval;
+	// Mapped pages are only copied when a string in them is unescaped
+	struct JSONFile file;
+	if (json_file_open(&file, filepath, 1))
+		return NULL;
+	JSONBatch* batch = json_batch_load(file.data, file.data + file.size, 1, threads);
+	if (batch == NULL)
+	{
+		json_file_close(&file);
+		return NULL;
+	}
+	batch->file = file;
+	return batch;
 }
 
-double json_get_number(JSON* object)
+size_t json_batch_count(JSONBatch* batch)
 {
-	return object->numval;
+	return batch->count;
 }
 
-int json_get_bool(JSON* object)
+JSON* json_batch_get(JSONBatch* batch, size_t index)
 {
-	return object->numval;
+	if (index >= batch->count)
+		return NULL;
+	return batch->records[index];
 }
 
-char* json_get_member_string(JSON* object, const char* name)
+void json_batch_destroy(JSONBatch* batch)
 {
-	JSON* tmp = json_get_member(object, name);
-	if (tmp == NULL)
-		return NULL;
-	return tmp->stringval;
+	for (size_t i = 0; i < batch->chunk_count; i++)
+		JSON_FREE(batch->chunks[i].records);
+	JSON_FREE(batch->chunks);
+	for (int i = 0; i < batch->worker_count; i++)
+		json_arena_free(&batch->workers[i].arena);
+	JSON_FREE(batch->workers);
+	JSON_FREE(batch->records);
+	if (batch->file.data)
+		json_file_close(&batch->file);
+	JSON_FREE(batch);
 }
 
-// Gets a member of an object and returns its number value
-double json_get_member_number(JSON* object, const char* name)
+// A part of a document scanned by one thread to find where the members or elements of the root can be split
+struct JSONScanRange
 {
-	JSON* tmp = json_get_member(object, name);
-	if (tmp == NULL)
-		return 0;
-	return tmp->numval;
+	// The document between the brackets of the root, which the range is part of
+	char* begin;
+	char* str;
+	char* end;
+	// The number of quotes in the range that start or end a string
+	size_t quotes;
+	// Set if the range starts inside a string
+	int in_string;
+	// The depth at the start of the range, where the members or elements of the root are at depth 0
+	long depth;
+	// The change of depth over the range, and the lowest depth relative to the start
+	long delta;
+	long lowest;
+	// The first comma in the range separating two members or elements of the root, NULL if there is none
+	char* split;
+};
+
+// Returns non zero if the quote at p is escaped by an odd number of backslashes
+static int json_scan_escaped(const char* p, const char* begin)
+{
+	const char* q = p;
+	while (q > begin && q[-1] == '\\')
+		q--;
+	return (p - q) & 1;
 }
 
-// Gets a member of an object and returns its bool value
-int json_get_member_bool(JSON* object, const char* name)
+#if JSON_SSE2
+// Counts the quotes that start or end a string, which don't depend on whether the range starts in a string
+static void json_scan_quotes(void* ctx)
 {
-	JSON* tmp = json_get_member(object, name);
-	if (tmp == NULL)
-		return 0;
-	return tmp->numval;
+	struct JSONScanRange* range = ctx;
+	struct JSONScanner scanner;
+	json_scanner_init(&scanner, 0, json_scan_escaped(range->str, range->begin));
+	for (char* p = range->str; p < range->end; p += 64)
+	{
+		struct JSONBlockMasks m;
+		json_scanner_next(&scanner, p, range->end, &m);
+		range->quotes += json_popcount64(m.quote);
+	}
 }
 
-JSON* json_get_members(JSON* object)
+// Moves through the range a block at a time, entering and leaving strings and updating depth, and stops at a comma at
+// depth 0 if split is set
+// Returns the comma, or the end of the range
+static char* json_scan_walk(struct JSONScanRange* range, long* depth, int split)
 {
-	if (object->type != JSON_TOBJECT)
-		return NULL;
-	return object->members;
+	struct JSONScanner scanner;
+	json_scanner_init(&scanner, range->in_string, json_scan_escaped(range->str, range->begin));
+	for (char* p = range->str; p < range->end; p += 64)
+	{
+		struct JSONBlockMasks m;
+		json_scanner_next(&scanner, p, range->end, &m);
+		long opened = json_popcount64(m.open);
+		long closed = json_popcount64(m.close);
+
+		// The brackets are only followed one by one when the depth may reach a new low, or 0 at a comma
+		uint64_t commas = split && *depth - closed <= 0 && *depth + opened >= 0 ? m.comma : 0;
+		if (commas == 0 && *depth - closed >= range->lowest)
+		{
+			*depth += opened - closed;
+			continue;
+		}
+		for (uint64_t bits = m.open | m.close | commas; bits; bits &= bits - 1)
+		{
+			int i = json_ctz64(bits);
+			if (m.open >> i & 1)
+				(*depth)++;
+			else if (m.close >> i & 1)
+			{
+				(*depth)--;
+				if (*depth < range->lowest)
+					range->lowest = *depth;
+			}
+			else if (*depth == 0)
+				return p + i;
+		}
+	}
+	return range->end;
 }
 
-JSON* json_get_member(JSON* object, const char* name)
+#else
+// Counts the quotes that start or end a string, which don't depend on whether the range starts in a string
+static void json_scan_quotes(void* ctx)
 {
-	if (object->type != JSON_TOBJECT)
-		return NULL;
-	JSON* cur = object->members;
-	while (cur)
+	struct JSONScanRange* range = ctx;
+	char* p = range->str;
+	while ((p = memchr(p, '"', range->end - p)) != NULL)
 	{
-		if (strcmp(cur->name, name) == 0)
-			return cur;
-		cur = cur->next;
+		if (!json_scan_escaped(p, range->begin))
+			range->quotes++;
+		p++;
 	}
-	return NULL;
 }
 
-// Returns a linked list of the elements of a json array
-JSON* json_get_elements(JSON* object)
+// Moves through the range, entering and leaving strings and updating depth, and stops at a comma at depth 0 if split
+// is set
+// Returns the comma, or the end of the range
+static char* json_scan_walk(struct JSONScanRange* range, long* depth, int split)
 {
-	if (object->type != JSON_TARRAY)
-		return NULL;
-	return object->members;
+	int in_string = range->in_string;
+	char* end = range->end;
+	for (char* p = range->str; p < end; p++)
+	{
+		if (in_string)
+		{
+			p = memchr(p, '"', end - p);
+			if (p == NULL)
+				break;
+			if (!json_scan_escaped(p, range->begin))
+				in_string = 0;
+			continue;
+		}
+		switch (*p)
+		{
+		case '"':
+			in_string = 1;
+			break;
+		case '[':
+		case '{':
+			(*depth)++;
+			break;
+		case ']':
+		case '}':
+			(*depth)--;
+			if (*depth < range->lowest)
+				range->lowest = *depth;
+			break;
+		case ',':
+			if (split && *depth == 0)
+				return p;
+			break;
+		}
+	}
+	return end;
 }
+#endif
 
-int json_get_count(JSON* object)
+// Finds the change of depth over the range once it's known whether it starts in a string
+static void json_scan_depth(void* ctx)
 {
-	return object->count;
+	struct JSONScanRange* range = ctx;
+	json_scan_walk(range, &range->delta, 0);
 }
 
-// Returns the next item in the list element is a part of
-JSON* json_get_next(JSON* element)
+// Finds the first comma at depth 0 once the depth at the start of the range is known
+static void json_scan_split(void* ctx)
 {
-	return element->next;
+	struct JSONScanRange* range = ctx;
+	long depth = range->depth;
+	char* p = json_scan_walk(range, &depth, 1);
+	range->split = p < range->end ? p : NULL;
 }
 
-#define WRITE_NAME                                     \
-	if (ss->str && object->name)                       \
-	{                                                  \
-		json_ss_write(ss, "\"", 0);                    \
-		json_ss_write(ss, object->name, 1);            \
-		json_ss_write(ss, format ? "\": " : "\":", 0); \
+// Members or elements of the root parsed by one thread
+struct JSONSpan
+{
+	// From the first member or element up to and including the comma after the last one, or the end of the root
+	char* str;
+	char* end;
+	// The first span starts right after the bracket of the root and the last one ends with its closing bracket
+	int first;
+	int last;
+	// Holds the parsed members or elements
+	struct JSONLoader loader;
+	// Why and where the span is invalid, JSON_ERROR_NONE if it isn't
+	JSONError error;
+};
+
+struct JSONSpans
+{
+	struct JSONSpan* spans;
+	size_t count;
+	size_t next;
+	struct JSONMutex lock;
+	// The type of the root
+	int type;
+	// The whole string, which the offsets, lines, and columns of errors count from
+	char* str;
+};
+
+// Ends an object or array, except for the root whose children stay in the loader to be gathered from all spans
+static int json_span_end(void* ctx)
+{
+	struct JSONLoader* loader = ctx;
+	if (loader->depth == 1)
+	{
+		loader->depth--;
+		return 0;
 	}
+	return json_loader_end(ctx);
+}
+
+static const JSONHandler json_span_handler = {
+	.start_object = json_loader_start_object,
+	.end_object = json_span_end,
+	.start_array = json_loader_start_array,
+	.end_array = json_span_end,
+	.key = json_loader_key,
+	.string = json_loader_string_value,
+	.number = json_loader_number,
+	.integer = json_loader_integer,
+	.boolean = json_loader_boolean,
+	.null = json_loader_null,
+};
 
-void json_tostring_internal(JSON* object, struct JSONStringStream* ss, int format, size_t depth)
+// Parses spans until none are left, each as if continuing inside the root
+static void json_spans_work(void* ctx)
 {
-	if (object->type == JSON_TOBJECT || object->type == JSON_TARRAY)
+	struct JSONSpans* spans = ctx;
+	for (;;)
 	{
-		WRITE_NAME;
-		json_ss_write(ss, (object->type == JSON_TOBJECT ? "{" : "["), 0);
-		if (format)
-			json_ss_write(ss, "\n", 0);
+		json_mutex_lock(&spans->lock);
+		size_t index = spans->next < spans->count ? spans->next++ : spans->count;
+		json_mutex_unlock(&spans->lock);
+		if (index == spans->count)
+			break;
 
-		JSON* cur = object->members;
-		while (cur)
+		struct JSONSpan* span = &spans->spans[index];
+		JSON root;
+		struct JSONParser parser = {
+			.handler = &json_span_handler, .ctx = &span->loader, .end = span->end, .more = 1, .start = spans->str};
+		span->loader.root = &root;
+		char* result = json_parser_fail(&parser, JSON_ERROR_MEMORY, span->str);
+		if (json_loader_open(&span->loader, spans->type) == 0 && json_parser_push(&parser, span->str, spans->type))
 		{
-			// Format with tabs
-			if (format)
-			{
-				for (size_t i = 0; i < depth + 1; i++)
-				{
-					json_ss_write(ss, "\t", 0);
-				}
-			}
-			json_tostring_internal(cur, ss, format, depth + 1);
-			cur = cur->next;
-			if (cur)
-				json_ss_write(ss, (format ? ",\n" : ","), 0);
+			if (spans->type == JSON_TOBJECT)
+				parser.state = span->first ? JSON_PARSE_FIRST_KEY : JSON_PARSE_KEY;
+			else
+				parser.state = span->first ? JSON_PARSE_FIRST_VALUE : JSON_PARSE_VALUE;
+			result = json_parse_internal(&parser, span->str);
 		}
-		if (format)
+
+		// Every span but the last ends after a comma, waiting for the next member or element
+		if (result && result != span->end)
+			result = json_parser_fail(&parser, JSON_ERROR_TRAILING, result);
+		else if (result && parser.depth != (span->last ? 0u : 1u))
+			result = json_parser_fail(&parser, JSON_ERROR_END, result);
+		if (result == NULL)
 		{
-			json_ss_write(ss, "\n", 0);
-			for (size_t i = 0; i < depth; i++)
-			{
-				json_ss_write(ss, "\t", 0);
-			}
+			json_parser_report(&parser, &span->error);
+			// The loader only stops parsing when memory couldn't be allocated
+			if (span->error.code == JSON_ERROR_STOPPED)
+				span->error.code = JSON_ERROR_MEMORY;
 		}
-		json_ss_write(ss, (object->type == JSON_TOBJECT ? "}" : "]"), 0);
+		JSON_FREE(parser.scratch);
+		JSON_FREE(parser.stack);
 	}
-	else if (object->type == JSON_TSTRING)
-	{
-		WRITE_NAME;
-		json_ss_write(ss, "\"", 0);
+}
 
-		json_ss_write(ss, object->stringval, 1);
-		json_ss_write(ss, "\"", 0);
+// Splits the document between the brackets at begin and end into spans of members or elements parsed on threads, and
+// gathers them into root
+// Returns 1 if the document was loaded, 0 if it's invalid, in which case error is set to the first error in str unless
+// it is NULL, and -1 if it can't be split, in which case it is loaded on one thread
+static int json_load_split(JSON* root, char* str, char* begin, char* end, int threads, JSONError* error)
+{
+	int type = begin[-1] == '[' ? JSON_TARRAY : JSON_TOBJECT;
+
+	// Find out where strings start and end, then the depth, then the commas at depth 0, each pass in parallel
+	struct JSONScanRange* ranges = JSON_MALLOC(threads * sizeof(struct JSONScanRange));
+	if (ranges == NULL)
+		return -1;
+	size_t size = (end - begin) / threads;
+	for (int i = 0; i < threads; i++)
+	{
+		char* str = begin + i * size;
+		ranges[i] = (struct JSONScanRange){begin, str, i == threads - 1 ? end : str + size, 0, 0, 0, 0, 0, NULL};
 	}
-	else if (object->type == JSON_TNUMBER)
+	json_threads_run(json_scan_quotes, ranges, sizeof(struct JSONScanRange), threads);
+	size_t quotes = 0;
+	for (int i = 0; i < threads; i++)
 	{
-		WRITE_NAME;
-		char buf[128];
-		json_ftos(object->numval, buf, 5);
-		json_ss_write(ss, buf, 0);
+		ranges[i].in_string = quotes & 1;
+		quotes += ranges[i].quotes;
 	}
-	else if (object->type == JSON_TBOOL)
+	json_threads_run(json_scan_depth, ranges, sizeof(struct JSONScanRange), threads);
+	long depth = 0;
+	for (int i = 0; i < threads; i++)
+	{
+		ranges[i].depth = depth;
+		// The root must not be closed early
+		if (depth + ranges[i].lowest < 0)
+			quotes = 1;
+		depth += ranges[i].delta;
+	}
+	if (quotes & 1 || depth != 0)
+	{
+		JSON_FREE(ranges);
+		return -1;
+	}
+	json_threads_run(json_scan_split, ranges, sizeof(struct JSONScanRange), threads);
+
+	// Every comma found ends a span
+	struct JSONSpans spans = {.spans = JSON_MALLOC((threads + 1) * sizeof(struct JSONSpan)), .type = type, .str = str};
+	if (spans.spans == NULL)
 	{
-		WRITE_NAME;
-		json_ss_write(ss, object->numval ? "true" : "false", 0);
+		JSON_FREE(ranges);
+		return -1;
 	}
-	else if (object->type == JSON_TNULL)
+	char* span_str = begin;
+	for (int i = 0; i <= threads; i++)
 	{
-		WRITE_NAME;
-		json_ss_write(ss, "null", 0);
+		if (i < threads && ranges[i].split == NULL)
+			continue;
+		char* span_end = i < threads ? ranges[i].split + 1 : end + 1;
+		spans.spans[spans.count] = (struct JSONSpan){span_str, span_end, span_str == begin, i == threads, {0}, {0}};
+		spans.count++;
+		span_str = span_end;
 	}
-}
+	JSON_FREE(ranges);
 
-char* json_tostring(JSON* object, int format)
-{
-	struct JSONStringStream ss = {0};
-
-	json_tostring_internal(object, &ss, format, 0);
-	return ss.str;
-}
+	json_mutex_init(&spans.lock);
+	json_threads_run(json_spans_work, &spans, 0, threads);
+	json_mutex_destroy(&spans.lock);
 
-int json_writefile(JSON* object, const char* filepath, int format)
-{
-// Create directories leading up
-#if JSON_USE_POSIX
-	const char* p = filepath;
-	char tmp_path[FILENAME_MAX];
-	size_t len = 0;
-	struct stat st = {0};
-	for (; *p != '\0'; p++)
+	// Gather the children of the root from all spans in order, or report the error of the first invalid span
+	int failed = 0;
+	size_t count = 0;
+	for (size_t i = 0; i < spans.count; i++)
 	{
-		// Dir separator hit
-		if (*p == '/')
+		if (!failed && spans.spans[i].error.code != JSON_ERROR_NONE)
 		{
-			len = p - filepath;
-
-			memcpy(tmp_path, filepath, len);
-			tmp_path[len] = '\0';
-
-			// Dir already exists
-			if (stat(tmp_path, &st) == 0)
-			{
-				continue;
-			}
-			if (mkdir(tmp_path, 0777))
-			{
-				char msg[512];
-				snprintf(msg, sizeof msg, "Failed to create directory %s", tmp_path);
-				JSON_MESSAGE(msg);
-				return -1;
-			}
+			failed = 1;
+			if (error)
+				*error = spans.spans[i].error;
 		}
+		count += spans.spans[i].loader.size;
 	}
-#elif JSON_USE_WINAPI
-	char* p = filepath;
-	const char tmp_path[FILENAME_MAX];
-	for (; *p != '\0'; p++)
+	struct JSONLoader loader = {.root = root};
+	loader.items = failed ? NULL : JSON_MALLOC((count ? count : 1) * sizeof(struct JSONLoaderItem));
+	if (loader.items)
 	{
-		// Dir separator hit
-		if (*p == '/' || *p == '\\')
+		for (size_t i = 0; i < spans.count; i++)
 		{
-			size_t len = p - filepath;
-			memcpy(tmp_path, filepath, p - filepath);
-			tmp_path[len] = '\0';
-			CreateDirectoryA(tmp_path, NULL);
+			if (spans.spans[i].loader.size)
+				memcpy(loader.items + loader.size, spans.spans[i].loader.items,
+					   spans.spans[i].loader.size * sizeof(struct JSONLoaderItem));
+			loader.size += spans.spans[i].loader.size;
+			spans.spans[i].loader.size = 0;
 		}
+		root->type = type;
 	}
-#endif
-	FILE* fp = NULL;
-	fp = fopen(filepath, "w");
-	if (fp == NULL)
-	{
-
-		char msg[512];
-		snprintf(msg, sizeof msg, "Failed to create or open file %s", filepath);
-		JSON_MESSAGE(msg);
-		return -2;
-	}
-	struct JSONStringStream ss = {0};
-	json_tostring_internal(object, &ss, format, 0);
-	fwrite(ss.str, 1, ss.length, fp);
-
-	// Exit
-	JSON_FREE(ss.str);
-	fclose(fp);
-	return 0;
+	int result = loader.items && json_loader_close(&loader, root, 0) == 0;
+	if (!result && !failed)
+		json_error_memory(error);
+	for (size_t i = 0; i < spans.count; i++)
+		json_loader_free(&spans.spans[i].loader, 1);
+	json_loader_free(&loader, !result);
+	JSON_FREE(spans.spans);
+	return result;
 }
 
-JSON* json_loadfile(const char* filepath)
+// Loads the string from str to end into a new tree, splitting a large array or object between threads
+// If the string is invalid, error is set to why and where unless it is NULL
+static JSON* json_load_parallel(char* str, char* end, int threads, JSONError* error)
 {
-	FILE* fp;
-	fp = fopen(filepath, "r");
-	if (fp == NULL)
+	JSON* root = json_create_empty();
+	if (root == NULL)
 	{
-		char msg[512];
-		snprintf(msg, sizeof msg, "Failed to open file %s", filepath);
-		JSON_MESSAGE(msg);
+		json_error_memory(error);
 		return NULL;
 	}
+	threads = json_threads_count(threads);
+
+	// Only the outermost object or array is split, with some work for every thread
+	char* begin = str;
+	while (begin < end && JSON_IS_WHITESPACE(*begin))
+		begin++;
+	char* last = end;
+	while (last > begin && JSON_IS_WHITESPACE(last[-1]))
+		last--;
+	int result = -1;
+	if (threads > 1 && last - begin >= 2 * JSON_BATCH_CHUNK &&
+		((*begin == '[' && last[-1] == ']') || (*begin == '{' && last[-1] == '}')))
+	{
+		if ((size_t)threads > (size_t)(last - begin) / JSON_BATCH_CHUNK)
+			threads = (int)((last - begin) / JSON_BATCH_CHUNK);
+		result = json_load_split(root, str, begin + 1, last - 1, threads, error);
+	}
 
-	// Read the file into a string
-	char* buf = NULL;
-	size_t size;
-	fseek(fp, 0L, SEEK_END);
-	size = ftell(fp);
-	buf = JSON_MALLOC(size);
-	fseek(fp, 0L, SEEK_SET);
-	fread(buf, 1, size, fp);
-	fclose(fp);
-
-	JSON* root = json_create_empty();
-	if (json_load(root, buf) == NULL)
+	if (result < 0 && json_load_root(root, str, end, NULL, NULL, 0, error) == NULL)
+		result = 0;
+	if (result == 0)
 	{
-		char msg[512];
-		snprintf(msg, sizeof msg, "File %s contains none or invalid json data", filepath);
-		JSON_MESSAGE(msg);
-		JSON_FREE(root);
-		JSON_FREE(buf);
+		json_destroy(root);
 		return NULL;
 	}
-	root->name = strduplicate(filepath);
-	JSON_FREE(buf);
 	return root;
 }
-JSON* json_loadstring(char* str)
+
+JSON* json_loadbuffer_parallel(const char* buf, size_t len, int threads)
 {
-	JSON* root = json_create_empty();
-	if (json_load(root, str) == NULL)
-	{
-		JSON_MESSAGE("String contains none or invalid json data");
-		JSON_FREE(root);
-		return NULL;
-	}
+	JSONError error;
+	JSON* root = json_loadbuffer_parallel_error(buf, len, threads, &error);
+	if (root == NULL)
+		json_error_message("String", &error);
 	return root;
 }
 
-char* json_load(JSON* object, char* str)
+JSON* json_loadbuffer_parallel_error(const char* buf, size_t len, int threads, JSONError* error)
 {
-	object->type = JSON_TINVALID;
+	// The buffer is never written to
+	return json_load_parallel((char*)buf, (char*)buf + len, threads, error);
+}
 
-	object->name = NULL;
-	object->stringval = NULL;
-	object->numval = 0;
-	object->members = NULL;
-	object->count = 0;
-	object->next = NULL;
+JSON* json_loadfile_parallel(const char* filepath, int threads)
+{
+	struct JSONFile file;
+	if (json_file_open(&file, filepath, 0))
+		return NULL;
 
-	// Object
-	if (str[0] == '{')
+	JSONError error;
+	JSON* root = json_load_parallel(file.data, file.data + file.size, threads, &error);
+	json_file_close(&file);
+	if (root == NULL)
 	{
-		object->type = JSON_TOBJECT;
-
-		char* tmp_name = NULL;
-		str++;
-		for (; *str != '\0'; str++)
-		{
-			// Skip whitespace
-			if (JSON_IS_WHITESPACE(*str))
-			{
-				continue;
-			}
-
-			// Read the name
-			if (*str == '"')
-			{
-				char* tmp = json_read_quote(str, &tmp_name);
-				if (tmp == NULL)
-				{
-					char msg[512];
-					snprintf(msg, sizeof msg, "Error reading characters in string \"%.15s\"", str);
-					JSON_MESSAGE(msg);
-					break;
-				}
-				str = tmp;
-			}
-
-			// Next side of key value pair
-			// After reading the key, recursively load the value
-			if (*str == ':')
-			{
-				// Jump over ':'
-				str++;
-				// Skip all whitespace after ':'
-				while (*str == ' ' || *str == '\t' || *str == '\n')
-					str++;
-
-				// Load the json with what is after the ':'
-				JSON* new_object = json_create_empty();
-
-				// Load the child element from the string and skip over that string
-				char* tmp_buf = json_load(new_object, str);
-
-				if (tmp_buf == NULL || new_object->type == JSON_TINVALID)
-				{
-					char msg[512];
-					snprintf(msg, sizeof msg, "Invalid json %.15s", str);
-					JSON_MESSAGE(msg);
-					json_destroy(new_object);
-				}
-				else
-				{
-					str = tmp_buf;
-				}
-
-				// Insert member
-				json_add_member(object, tmp_name, new_object);
-				JSON_FREE(tmp_name);
+		char source[512];
+		snprintf(source, sizeof source, "File %s", filepath);
+		json_error_message(source, &error);
+		return NULL;
+	}
+	root->up.name = strduplicate(filepath);
+	root->flags |= JSON_FLAG_NAME;
+	return root;
+}
 
-				// Skip to next comma or quit
-				for (; *str != '\0'; str++)
-				{
-					if (*str == ',')
-						break;
-					if (*str == '}')
-						return str + 1;
-					if (JSON_IS_WHITESPACE(*str))
-						continue;
-					char msg[512];
-					snprintf(msg, sizeof msg, "Unexpected character before comma %.15s", str);
-					JSON_MESSAGE(msg);
-					return NULL;
-				}
-				if (*str == '\0')
-				{
-					JSON_MESSAGE("Expected comma before end of string");
-					return NULL;
-				}
-				continue;
-			}
+// The least elements json_extract_parallel gives each thread
+#define JSON_EXTRACT_CHUNK 16384
 
-			char msg[512];
-			snprintf(msg, sizeof msg, "Expected property before \"%.15s\"", str);
-			JSON_MESSAGE(msg);
-			return str;
-		}
-	}
+// The elements of an array one thread extracts a member of
+struct JSONExtract
+{
+	JSON** items;
+	size_t count;
+	const char* name;
+	int type;
+	// The values of the elements, from the first of items on
+	void* out;
+};
 
-	// Array
-	else if (str[0] == '[')
+static void json_extract_work(void* ctx)
+{
+	struct JSONExtract* extract = ctx;
+	// Objects of the same shape share their names, and nothing is modified while extracting, so objects with the
+	// names of the last object the member was found in have it in the same slot
+	char** shape = NULL;
+	int slot = -1;
+	for (size_t i = 0; i < extract->count; i++)
 	{
-		object->type = JSON_TARRAY;
-
-		str++;
-		for (; *str != '\0'; str++)
+		JSON* item = extract->items[i];
+		JSON* member = NULL;
+		if (item->type == JSON_TOBJECT && item->val.children)
 		{
-			// Skip whitespace
-			if (JSON_IS_WHITESPACE(*str))
-				continue;
-
-			// The end of the array
-			if (*str == ']')
-				return str + 1;
-
-			// Read elements of array
-
+			if (item->val.children->names == shape)
+				member = item->val.children->items[slot];
+			else
 			{
-				JSON* new_object = json_create_empty();
-
-				// Load the element from the string
-				char* tmp_buf = json_load(new_object, str);
-				if (tmp_buf == NULL)
-				{
-					JSON_MESSAGE("Invalid json");
-					json_destroy(new_object);
-				}
-				else
-				{
-					str = tmp_buf;
-				}
-
-				// Insert element at end
-				json_add_element(object, new_object);
-
-				// Skip to next comma or quit
-				for (; *str != '\0'; str++)
-				{
-					if (*str == ',')
-						break;
-					if (*str == ']')
-						return str + 1;
-					if (JSON_IS_WHITESPACE(*str))
-						continue;
-					char msg[512];
-					snprintf(msg, sizeof msg, "Unexpected character before comma \"%.15s\"\n", str);
-					JSON_MESSAGE(msg);
-					return str;
-				}
-			}
-
-			// The end of the array
-			if (*str == ']')
-			{
-				return str + 1;
+				member = json_get_member_cached(item, extract->name, &slot);
+				shape = member ? item->val.children->names : NULL;
 			}
 		}
-	}
 
-	// String
-	else if (str[0] == '"')
-	{
-		object->type = JSON_TSTRING;
-		return json_read_quote(str, &object->stringval);
-	}
-	// Number
-	else if ((*str >= '0' && *str <= '9') || *str == '-' || *str == '+')
-	{
-		object->type = JSON_TNUMBER;
-		return json_stof(str, &object->numval);
+		if (extract->type == JSON_TNUMBER)
+			((double*)extract->out)[i] = member ? json_get_number(member) : 0;
+		else if (extract->type == JSON_TSTRING)
+			((char**)extract->out)[i] = member ? json_get_string(member) : NULL;
+		else
+			((int*)extract->out)[i] = member ? json_get_bool(member) : 0;
 	}
+}
 
-	// Bool true
-	else if (strncmp(str, "true", 4) == 0)
+size_t json_extract_parallel(JSON* array, const char* name, int type, void* out, size_t n, int threads)
+{
+	if (array->type != JSON_TARRAY || array->val.children == NULL)
+		return 0;
+	// The elements of an array have no holes
+	size_t count = array->val.children->count;
+	if (count > n)
+		count = n;
+
+	size_t size = type == JSON_TNUMBER ? sizeof(double) : type == JSON_TSTRING ? sizeof(char*) : sizeof(int);
+	threads = json_threads_count(threads);
+	if ((size_t)threads > count / JSON_EXTRACT_CHUNK)
+		threads = count / JSON_EXTRACT_CHUNK > 1 ? (int)(count / JSON_EXTRACT_CHUNK) : 1;
+	struct JSONExtract single;
+	struct JSONExtract* extracts = threads > 1 ? JSON_MALLOC(threads * sizeof(struct JSONExtract)) : &single;
+	if (extracts == NULL)
 	{
-		object->type = JSON_TBOOL;
-		object->numval = 1;
-		return str + 4;
+		extracts = &single;
+		threads = 1;
 	}
-
-	// Bool true
-	else if (strncmp(str, "false", 5) == 0)
+	for (int i = 0; i < threads; i++)
 	{
-		object->type = JSON_TBOOL;
-		object->numval = 0;
-		return str + 5;
+		size_t begin = count * i / threads;
+		size_t end = count * (i + 1) / threads;
+		extracts[i] = (struct JSONExtract){array->val.children->items + begin, end - begin, name, type,
+										   (char*)out + begin * size};
 	}
+	json_threads_run(json_extract_work, extracts, sizeof(struct JSONExtract), threads);
+	if (extracts != &single)
+		JSON_FREE(extracts);
+	return count;
+}
 
-	else if (strncmp(str, "null", 4) == 0)
-	{
-		object->type = JSON_TNULL;
-		return str + 4;
-	}
+size_t json_extract_numbers(JSON* array, const char* name, double* out, size_t n)
+{
+	return json_extract_parallel(array, name, JSON_TNUMBER, out, n, 1);
+}
 
-	return NULL;
+size_t json_extract_strings(JSON* array, const char* name, char** out, size_t n)
+{
+	return json_extract_parallel(array, name, JSON_TSTRING, out, n, 1);
+}
+
+size_t json_extract_bools(JSON* array, const char* name, int* out, size_t n)
+{
+	return json_extract_parallel(array, name, JSON_TBOOL, out, n, 1);
 }
 
 void json_destroy_member(JSON* object, const char* name)
@@ -1246,250 +6030,198 @@ void json_destroy_element(JSON* object, int pos)
 // Removes and returns a member from the json structure
 JSON* json_pop_member(JSON* object, const char* name)
 {
-	if (object->type != JSON_TOBJECT)
+	if (object->type != JSON_TOBJECT || object->val.children == NULL)
 		return NULL;
-	JSON* cur = object->members;
-	JSON* prev = NULL;
-	while (cur && strcmp(cur->name, name) != 0)
+
+	struct JSONChildren* children = object->val.children;
+	int slot = -1;
+	if (children->index)
 	{
-		prev = cur;
-		cur = cur->next;
+		struct JSONIndexEntry* entry = json_index_find(children, name, json_hash(name));
+		if (entry)
+		{
+			slot = entry->slot;
+			entry->slot = JSON_INDEX_TOMBSTONE;
+		}
 	}
+	else
+		slot = json_find_slot(children, name);
+
 	// Name was not found
-	if (cur == NULL)
+	if (slot < 0)
 	{
 		return NULL;
 	}
 
-	object->count--;
-	// Handle first item
-	// Set to the following item or NULL
-	if (prev == NULL)
-	{
-		object->members = cur->next;
-		// The previous item of the first item points to the tail and list isn't empty
-		if (object->members)
-			object->members->prev = cur->prev;
-		cur->next = NULL;
-		cur->prev = NULL;
-		return cur;
-	}
-	// End
-	if (cur->next == NULL)
-	{
-		prev->next = NULL;
-		// Update first element's prev point to tail
-		object->members->prev = prev;
-		cur->next = NULL;
-		cur->prev = NULL;
-		return cur;
-	}
-
-	// Middle
-	prev->next = cur->next;
-	cur->next->prev = cur->prev;
-	cur->next = NULL;
-	cur->prev = NULL;
+	// Leave a hole to keep the other members' slots, the member keeps its name
+	JSON* cur = children->items[slot];
+	children->items[slot] = NULL;
+	children->count--;
+	cur->up.name = children->names[slot];
+	cur->flags |= JSON_FLAG_NAME;
+	cur->pos = 0;
+
+	// Trailing holes can be dropped right away
+	while (children->length > 0 && children->items[children->length - 1] == NULL)
+		children->length--;
 	return cur;
 }
 
 // Removes and returns an element from the json structure
 JSON* json_pop_element(JSON* object, int pos)
 {
-	if (object->type != JSON_TARRAY)
+	if (object->type != JSON_TARRAY || object->val.children == NULL)
+		return NULL;
+
+	struct JSONChildren* children = object->val.children;
+	if (children->count == 0 || pos >= children->count)
 		return NULL;
 
 	// Special tail case
 	if (pos < 0)
-	{
-		JSON* tail = object->members->prev;
-		object->members->prev = tail->prev;
-		tail->prev = NULL;
-		return tail;
-	}
+		pos = children->count - 1;
 
-	JSON* cur = object->members;
-	JSON* prev = NULL;
-	int idx = 0;
-	// Loop to either index or end of list
-	while (cur != NULL && idx != pos)
-	{
-		++idx;
-		prev = cur;
-		cur = cur->next;
-	}
+	JSON* element = children->items[pos];
+	children->count--;
+	children->length--;
 
-	// Index was not found
-	if (cur == NULL)
+	// Shift the following elements down
+	memmove(children->items + pos, children->items + pos + 1, (children->count - pos) * sizeof(JSON*));
+	for (int i = pos; i < children->count; i++)
+		children->items[i]->pos = i;
+
+	element->up.parent = NULL;
+	element->pos = 0;
+	return element;
+}
+
+// Makes value a child of object at slot, releasing the name of a previously popped node
+static void json_adopt(JSON* object, JSON* value, int slot)
+{
+	if (value->flags & JSON_FLAG_NAME)
 	{
-		return NULL;
+		if (!(value->flags & JSON_FLAG_SHARED))
+			JSON_FREE(value->up.name);
+		value->flags &= ~(JSON_FLAG_NAME | JSON_FLAG_SHARED);
 	}
-	object->count--;
-	// Handle first item
-	// Set to the following item or NULL
-	if (prev == NULL)
-	{
-		object->members = cur->next;
-		// Set tail pointer
-		// List isn't empty
-		if (object->members)
-			object->members->prev = cur->prev;
-		cur->next = NULL;
-		cur->prev = NULL;
-		return cur;
-	}
-
-	// End
-	if (cur->next == NULL)
-	{
-		cur->prev->next = NULL;
-		// Update first element's prev point to tail
-		object->members->prev = cur->prev;
-		cur->next = NULL;
-		cur->prev = NULL;
-		return cur;
-	}
-
-	// Middle
-	prev->next = cur->next;
-	cur->next->prev = cur->prev;
-	cur->next = NULL;
-	cur->prev = NULL;
-	return cur;
+	value->up.parent = object;
+	value->pos = slot;
 }
 
-void json_add_member(JSON* object, const char* name, JSON* value)
+// Adds a member whose name is copied, or used as is if shared
+static void json_add_member_name(JSON* object, const char* name, JSON* value, int shared)
 {
-	value->next = NULL;
-	value->prev = NULL;
 	if (object->type != JSON_TOBJECT)
 	{
 		json_set_invalid(object);
+		object->type = JSON_TOBJECT;
 	}
-	object->type = JSON_TOBJECT;
-
-	value->name = strduplicate(name);
 
-	// If list is empty
-	if (object->members == NULL)
+	// Duplicate, replace in place
+	struct JSONChildren* children = object->val.children;
+	int slot = children ? json_find_slot(children, name) : -1;
+	if (slot >= 0)
 	{
-		object->members = value;
+		// The name in the slot is kept, together with whether it's shared
+		int flags = children->items[slot]->flags & JSON_FLAG_SHARED;
+		json_destroy(children->items[slot]);
+		children->items[slot] = value;
+		json_adopt(object, value, slot);
+		value->flags |= flags;
 		return;
 	}
 
-	// Traverse to end of array and look for duplicate
-	JSON* cur = object->members;
-	while (cur->next && strcmp(cur->name, name) != 0)
+	// Insert at tail
+	if (json_children_reserve(object))
+		return;
+	children = object->val.children;
+	slot = children->length++;
+	children->count++;
+	children->items[slot] = value;
+	json_adopt(object, value, slot);
+	if (shared)
 	{
-		cur = cur->next;
+		children->names[slot] = (char*)name;
+		value->flags |= JSON_FLAG_SHARED;
 	}
-
-	// No duplicate, insert at tail
-	if (cur->next == NULL)
+	else
 	{
-		object->count++;
-		cur->next = value;
-		value->prev = cur;
-		// Update first element's prev point to new tail
-		object->members->prev = value;
-		return;
+		children->names[slot] = strduplicate(name);
+		JSON_STATS_ALLOC(names, strlen(name) + 1);
 	}
 
-	// Duplicate, replace
-	value->next = cur->next;
-	value->prev = cur->prev;
-
-	// Handle end
-	// Update tail
-	if (cur->next == NULL)
-	{
-		object->members->prev = value;
-	}
-	// Update the prev item's next pointer
-	// Not beginning of list
-	if (cur->prev->next)
+	if (children->index)
 	{
-		cur->prev->next = value;
+		// Keep the load factor below 3/4, tombstones count as used
+		if ((children->index->used + 1) * 4 > children->index->capacity * 3)
+			json_index_build(children);
+		else
+			json_index_put(children->index, slot, json_hash(name));
 	}
-	// Handle beginning of empty list
-	else
+	else if (children->count >= JSON_INDEX_THRESHOLD)
+		json_index_build(children);
+}
+
+void json_add_member(JSON* object, const char* name, JSON* value)
+{
+	json_add_member_name(object, name, value, 0);
+}
+
+void json_add_member_shared(JSON* object, const char* name, JSON* value)
+{
+	json_add_member_name(object, name, value, 1);
+}
+
+JSONKeys* json_keys_create()
+{
+	JSONKeys* keys = JSON_MALLOC(sizeof(JSONKeys));
+	if (keys == NULL)
 	{
-		object->members = value;
-		// Link pointer to tail to itself
-		value->prev = value;
+		JSON_MESSAGE("Failed to allocate memory for keys");
+		return NULL;
 	}
-	json_destroy(cur);
-	return;
+	json_keys_init(keys, &keys->own, (size_t)-1);
+	json_arena_init(&keys->own, 0);
+	return keys;
+}
+
+const char* json_keys_intern(JSONKeys* keys, const char* name)
+{
+	return json_keys_find(keys, name, strlen(name), 1);
+}
+
+void json_keys_destroy(JSONKeys* keys)
+{
+	JSON_FREE(keys->entries);
+	json_arena_free(&keys->own);
+	JSON_FREE(keys);
 }
 
 void json_insert_element(JSON* object, int pos, JSON* element)
 {
-	element->next = NULL;
-	element->prev = NULL;
 	if (object->type != JSON_TARRAY)
 	{
 		json_set_invalid(object);
+		object->type = JSON_TARRAY;
 	}
-	object->type = JSON_TARRAY;
-	object->count++;
 
-	// List is empty
-	if (object->members == NULL)
-	{
-		object->members = element;
-		// Tail points to itself
-		element->prev = element;
-		element->next = NULL;
+	if (json_children_reserve(object))
 		return;
-	}
+	struct JSONChildren* children = object->val.children;
 
 	// Quick tail insertion
-	if (pos < 0)
-	{
-		JSON* tail = object->members->prev;
-		tail->next = element;
-		element->prev = tail;
-		object->members->prev = element;
-		return;
-	}
-
-	JSON* cur = object->members;
-	JSON* prev = NULL;
-	int idx = 0;
-	// Jump to index or end of array
-	while (cur != NULL && idx != pos)
-	{
-		idx++;
-		prev = cur;
-		cur = cur->next;
-	}
-
-	// Insert
-	// Beginning
-	if (prev == NULL)
-	{
-		object->members = element;
-		element->next = cur;
-		element->prev = cur->prev;
-		cur->prev = element;
-		return;
-	}
-
-	// End
-	if (cur == NULL)
-	{
-		prev->next = element;
-		element->prev = prev;
-		element->prev = cur;
-		// Update first element's prev point to new tail
-		object->members->prev = element;
-		return;
-	}
-	// Middle
-	prev->next = element;
-	element->prev = prev;
-	element->next = cur;
-	cur->prev = element;
+	if (pos < 0 || pos > children->count)
+		pos = children->count;
+
+	// Shift the following elements up
+	memmove(children->items + pos + 1, children->items + pos, (children->count - pos) * sizeof(JSON*));
+	for (int i = pos + 1; i <= children->count; i++)
+		children->items[i]->pos = i;
+
+	children->items[pos] = element;
+	children->count++;
+	children->length++;
+	json_adopt(object, element, pos);
 }
 
 void json_add_element(JSON* object, JSON* element)
@@ -1499,26 +6231,12 @@ void json_add_element(JSON* object, JSON* element)
 
 void json_destroy(JSON* object)
 {
-	JSON* cur = object->members;
-	while (cur)
-	{
-		JSON* next = cur->next;
-		json_destroy(cur);
-		cur = next;
-	}
+	json_destroy_value(object);
 
-	if (object->name)
-	{
-		JSON_FREE(object->name);
-		object->name = NULL;
-	}
-	if (object->stringval)
+	if ((object->flags & (JSON_FLAG_NAME | JSON_FLAG_SHARED)) == JSON_FLAG_NAME)
 	{
-		JSON_FREE(object->stringval);
-		object->stringval = NULL;
+		JSON_FREE(object->up.name);
 	}
-
-	object->numval = 0;
 	object->type = JSON_TINVALID;
 
 	JSON_FREE(object);
@@ -1,12 +1,14 @@
-tests = {"tests/parse.c", "tests/gen.c"}
+tests = {"tests/parse.c", "tests/gen.c", "tests/numbers.c", "tests/strings.c", "tests/errors.c", "tests/stats.c", "tests/keys.c", "tests/extract.c", "tests/chunks.c", "tests/utf8.c", "tests/write.c", "tests/lines.c", "tests/batch.c", "tests/parallel.c"}
+benches = {"bench/numbers.c", "bench/write.c", "bench/batch.c", "bench/suite.c"}
 
-function gen_tests()
-	for k, v in pairs(tests) do
+-- Generates a console app named prefix_name for every source file
+function gen_programs(sources, prefix)
+	for k, v in pairs(sources) do
 		b, e = v:find("/[a-z]+");
 		b=b+1;
 		name = v:sub(b,e);
-		print ("generating test", name)
-		project ("test_" .. name)
+		print ("generating " .. prefix, name)
+		project (prefix .. "_" .. name)
 			kind "ConsoleApp"
 			language "C"
 			targetdir "bin"
@@ -20,7 +22,7 @@ function gen_tests()
 			-- For posix compliant systems
 			filter "system:linux or bsd or hurd or aix or solaris or haiku or macosx"
 				defines { "JSON_USE_POSIX" }
-				links { "m" }
+				links { "m", "pthread" }
 
 			-- For windows
 			filter "system:windows"
@@ -45,12 +47,18 @@ newoption {
 	description = "Build the tests",
 }
 
+newoption {
+	trigger = "bench",
+	description = "Build the benchmarks",
+}
+
 workspace "jsonparser"
 	configurations { "Release", "Debug" }
 
 v = "tests/parse.c"
 
-if _OPTIONS["test"] then  gen_tests() end
+if _OPTIONS["test"] then  gen_programs(tests, "test") end
+if _OPTIONS["bench"] then  gen_programs(benches, "bench") end
 
 project "json"
 	kind "StaticLib"
@@ -65,7 +73,7 @@ project "json"
 	-- For posix compliant systems
 	filter "system:linux or bsd or hurd or aix or solaris or haiku or macosx"
 		defines { "JSON_USE_POSIX" }
-		links { "m" }
+		links { "m", "pthread" }
 	
 	-- For windows
 	filter "system:windows"
@@ -0,0 +1,98 @@
+// Small chunks, so that the input is split many times and chunks end on every kind of line
+#define JSON_BATCH_CHUNK 1024
+#define LIBJSON_IMPLEMENTATION
+#define MP_IMPLEMENTATION
+#define MP_CHECK_FULL
+#include "magpie.h"
+#include "libjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Checks that loading records on several threads gives the same records in the same order as reading them line by line
+
+int failures = 0;
+
+// Appends a random line to str: a record, a blank or whitespace only line, or an invalid line, ending in LF or CRLF
+size_t add_line(char* str, size_t len)
+{
+	switch (rand() % 8)
+	{
+	case 0:
+		break;
+	case 1:
+		len += sprintf(str + len, " \t ");
+		break;
+	case 2:
+		len += sprintf(str + len, "{\"id\": %d, \"tags\": [1, 2", rand());
+		break;
+	default:
+		len += sprintf(str + len, "{\"id\": %d, \"name\": \"line\\r\\n\", \"padding\": \"%*s\"}", rand(),
+					   rand() % 200, "");
+		break;
+	}
+	len += sprintf(str + len, rand() % 2 ? "\r\n" : "\n");
+	return len;
+}
+
+// Compares a batch of str with the records read one line at a time
+void check(const char* str, size_t len, int threads)
+{
+	JSONBatch* batch = json_batch_loadbuffer(str, len, threads);
+	JSONLines* lines = json_lines_openbuffer(str, len);
+	JSON* record;
+	size_t count = 0;
+	int result;
+	while ((result = json_lines_next(lines, &record)) != 0)
+	{
+		JSON* loaded = json_batch_get(batch, count);
+		char* expected = result == 1 ? json_tostring(record, JSON_COMPACT) : NULL;
+		char* written = loaded ? json_tostring(loaded, JSON_COMPACT) : NULL;
+		if ((expected == NULL) != (written == NULL) || (expected && strcmp(expected, written) != 0))
+		{
+			printf("%d threads: record %zu at line %zu differs\n", threads, count, json_lines_line(lines));
+			failures++;
+		}
+		free(expected);
+		free(written);
+		count++;
+	}
+	if (json_batch_count(batch) != count || json_batch_get(batch, count) != NULL)
+	{
+		printf("%d threads: %zu records instead of %zu\n", threads, json_batch_count(batch), count);
+		failures++;
+	}
+	json_lines_close(lines);
+	json_batch_destroy(batch);
+}
+
+int main()
+{
+	// Several chunks of lines, ending with a record without a newline, after room to shift the lines
+	size_t capacity = 64 * JSON_BATCH_CHUNK;
+	size_t shift = 256;
+	char* buf = malloc(shift + capacity + 512);
+	memset(buf, ' ', shift);
+	char* str = buf + shift;
+	size_t len = 0;
+	srand(7);
+	while (len < capacity)
+		len = add_line(str, len);
+	len += sprintf(str + len, "[\"last\"]");
+
+	for (int threads = 1; threads <= 8; threads++)
+		check(str, len, threads);
+
+	// Leading whitespace moves the chunk boundaries to every character of a line, including between CR and LF
+	for (size_t i = 1; i <= shift; i++)
+		check(str - i, len + i, 4);
+
+	// Inputs cut after every character of the last few lines
+	for (size_t end = len - 300; end < len; end++)
+		check(str, end, 4);
+
+	free(buf);
+	printf("%d failures\n", failures);
+	mp_terminate();
+	return failures != 0;
+}
@@ -0,0 +1,71 @@
+#define LIBJSON_IMPLEMENTATION
+#define MP_IMPLEMENTATION
+#define MP_CHECK_FULL
+#include "magpie.h"
+#include "libjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Checks that feeding json to the push parser in chunks of every size builds the same tree as loading it at once
+
+// Escapes, surrogate pairs, long numbers and exponents, and literals, which can all be cut off by a chunk, as well as
+// numbers and literals ending the input
+const char* docs[] = {
+	"{\"name\": \"Em\\\"ma\\\\\", \"escapes\": \"\\/\\b\\f\\n\\r\\t\\u00e9\\u20AC\", \"emoji\": \"\\ud83d\\ude00!\","
+	" \"max\": \"\\udbff\\udfff\", \"utf8\": \"caf\xc3\xa9\",\n\t\"numbers\": [12345678901234567890, "
+	"-9223372036854775808, -1.5e-300, 6.02214076E+23, 0.1, 0, -0.0, 1e2],\n\t\"literals\": [true, false, null], "
+	"\"empty\": [{}, [], \"\"], \"nested\": {\"a\": {\"b\": [[1], {\"c\": null}]}}}",
+	"  -12345.678e-9 ",
+	"123456789012",
+	"false",
+	"\"\\ud83d\\ude00\"",
+};
+
+int failures = 0;
+
+int main()
+{
+	for (size_t i = 0; i < sizeof docs / sizeof *docs; i++)
+	{
+		size_t len = strlen(docs[i]);
+		JSON* root = json_loadbuffer(docs[i], len);
+		char* expected = json_tostring(root, JSON_COMPACT);
+		json_destroy(root);
+
+		// Every chunk is overwritten after it was fed, since the parser mustn't keep pointers into it
+		char* chunk = malloc(len);
+		for (size_t size = 1; size <= len; size++)
+		{
+			JSONParser* parser = json_parser_create(NULL, NULL);
+			int result = 0;
+			for (size_t at = 0; at < len && result == 0; at += size)
+			{
+				size_t n = len - at < size ? len - at : size;
+				memcpy(chunk, docs[i] + at, n);
+				result = json_parser_feed(parser, chunk, n);
+				memset(chunk, '#', n);
+			}
+			if (result == 0)
+				result = json_parser_finish(parser);
+
+			JSON* chunked = result == 0 ? json_parser_root(parser) : NULL;
+			char* written = chunked ? json_tostring(chunked, JSON_COMPACT) : NULL;
+			if (written == NULL || strcmp(written, expected) != 0)
+			{
+				printf("document %zu in chunks of %zu: got %s\n", i, size, written ? written : "an error");
+				failures++;
+			}
+			free(written);
+			if (chunked)
+				json_destroy(chunked);
+			json_parser_destroy(parser);
+		}
+		free(chunk);
+		free(expected);
+	}
+
+	printf("%d failures\n", failures);
+	mp_terminate();
+	return failures != 0;
+}
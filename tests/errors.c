@@ -0,0 +1,125 @@
+#define LIBJSON_IMPLEMENTATION
+#define MP_IMPLEMENTATION
+#define MP_CHECK_FULL
+#include "magpie.h"
+#include "libjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Checks the code and position of errors reported by the loaders, the event parser, and the push parser
+
+struct Case
+{
+	const char* json;
+	int code;
+	size_t offset;
+	size_t line;
+	size_t column;
+};
+
+const struct Case cases[] = {{"", JSON_ERROR_END, 0, 1, 1},
+							 {"{\"a\" 1}", JSON_ERROR_COLON, 5, 1, 6},
+							 {"{\n\t\"a\": 1,\n\t\"b\": x\n}", JSON_ERROR_VALUE, 17, 3, 7},
+							 {"[1 2]", JSON_ERROR_COMMA, 3, 1, 4},
+							 {"{1: 2}", JSON_ERROR_NAME, 1, 1, 2},
+							 {"[1.]", JSON_ERROR_NUMBER, 1, 1, 2},
+							 {"[\"ab\\q\"]", JSON_ERROR_ESCAPE, 4, 1, 5},
+							 {"[\"\\ud800\"]", JSON_ERROR_ESCAPE, 2, 1, 3},
+							 {"[\"a\tb\"]", JSON_ERROR_CONTROL, 3, 1, 4},
+							 {"[1,\n\"abc", JSON_ERROR_END, 8, 2, 5}};
+
+int failures = 0;
+
+void check(const char* what, const struct Case* c, const JSONError* error, int lines)
+{
+	if (error->code != c->code || error->offset != c->offset ||
+		(lines && (error->line != c->line || error->column != c->column)))
+	{
+		printf("%s %s: got %s at %zu (%zu:%zu)\n", what, c->json, json_error_string(error->code), error->offset,
+			   error->line, error->column);
+		failures++;
+	}
+}
+
+int main()
+{
+	JSONHandler handler = {0};
+	for (size_t i = 0; i < sizeof cases / sizeof *cases; i++)
+	{
+		const struct Case* c = &cases[i];
+		size_t len = strlen(c->json);
+		JSONError error;
+
+		JSON* root = json_loadbuffer_error(c->json, len, &error);
+		check("json_loadbuffer_error", c, &error, 1);
+		if (root)
+			json_destroy(root);
+
+		if (json_parse_error(c->json, len, &handler, NULL, &error) != -1)
+			failures++;
+		check("json_parse_error", c, &error, 1);
+
+		// One character at a time, so that every token is carried over to the next chunk
+		JSONParser* parser = json_parser_create(NULL, NULL);
+		int result = 0;
+		for (size_t j = 0; j < len && result == 0; j++)
+			result = json_parser_feed(parser, c->json + j, 1);
+		if (result == 0)
+			result = json_parser_finish(parser);
+		json_parser_error(parser, &error);
+		check("json_parser_feed", c, &error, 0);
+		json_parser_destroy(parser);
+	}
+
+	// Objects and arrays nested too deep are rejected at the first bracket too many
+	char* deep = malloc(JSON_MAX_DEPTH + 1);
+	memset(deep, '[', JSON_MAX_DEPTH + 1);
+	JSONError error;
+	JSON* root = json_loadbuffer_error(deep, JSON_MAX_DEPTH + 1, &error);
+	if (root || error.code != JSON_ERROR_DEPTH || error.offset != JSON_MAX_DEPTH)
+	{
+		printf("expected depth error at %d\n", JSON_MAX_DEPTH);
+		failures++;
+	}
+	free(deep);
+
+	// Invalid lines are located in the whole input
+	const char* records = "{\"a\": 1}\n[1, 2\n";
+	JSONLines* lines = json_lines_openbuffer(records, strlen(records));
+	JSON* record;
+	if (json_lines_next(lines, &record) != 1 || json_lines_next(lines, &record) != -1)
+		failures++;
+	json_lines_error(lines, &error);
+	if (error.code != JSON_ERROR_END || error.offset != 14 || error.line != 2 || error.column != 6)
+	{
+		printf("json_lines_error: got %s at %zu (%zu:%zu)\n", json_error_string(error.code), error.offset, error.line,
+			   error.column);
+		failures++;
+	}
+	json_lines_close(lines);
+
+	// Errors in a range loaded on another thread are located in the whole input
+	// Every element takes a line of 3 bytes, so the array is split between 3 threads
+	size_t count = JSON_BATCH_CHUNK;
+	char* large = malloc(count * 3 + 1);
+	large[0] = '[';
+	for (size_t i = 0; i < count; i++)
+		memcpy(large + 1 + i * 3, "1,\n", 3);
+	large[count * 3 - 1] = ']';
+	size_t element = count / 3 * 2;
+	large[1 + element * 3] = 'x';
+	root = json_loadbuffer_parallel_error(large, count * 3, 4, &error);
+	if (root || error.code != JSON_ERROR_VALUE || error.offset != 1 + element * 3 || error.line != element + 1 ||
+		error.column != 1)
+	{
+		printf("json_loadbuffer_parallel_error: got %s at %zu (%zu:%zu)\n", json_error_string(error.code),
+			   error.offset, error.line, error.column);
+		failures++;
+	}
+	free(large);
+
+	printf("%d failures\n", failures);
+	mp_terminate();
+	return failures != 0;
+}
@@ -0,0 +1,68 @@
+#define LIBJSON_IMPLEMENTATION
+#define MP_IMPLEMENTATION
+#define MP_CHECK_FULL
+#include "magpie.h"
+#include "libjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Checks that extracting a member of every element gives the same values as looking them up one at a time
+
+int failures = 0;
+
+// Records of two shapes, other values, and records missing the member or with another type
+char* str = "[{\"balance\": 1.5, \"name\": \"Emma\", \"active\": true}, {\"name\": \"Liam\", \"balance\": 2}, 3, {}, "
+			"{\"balance\": \"none\"}, {\"balance\": 4, \"name\": \"Ava\", \"active\": false}, {\"balance\": 5}]";
+
+void check(JSON* array)
+{
+	double numbers[8];
+	char* strings[8];
+	int bools[8];
+	size_t count = json_extract_numbers(array, "balance", numbers, 8);
+	count += json_extract_strings(array, "name", strings, 8);
+	count += json_extract_bools(array, "active", bools, 8);
+	if (count != 3 * 7)
+	{
+		printf("expected 7 values\n");
+		failures++;
+		return;
+	}
+
+	int i = 0;
+	for (JSON* it = json_get_elements(array); it; it = json_get_next(it), i++)
+	{
+		int object = json_get_type(it) == JSON_TOBJECT;
+		if (numbers[i] != (object ? json_get_member_number(it, "balance") : 0) ||
+			strings[i] != (object ? json_get_member_string(it, "name") : NULL) ||
+			bools[i] != (object ? json_get_member_bool(it, "active") : 0))
+		{
+			printf("element %d: extracted values differ\n", i);
+			failures++;
+		}
+	}
+
+	// Only n values are written
+	numbers[2] = -1;
+	if (json_extract_parallel(array, "balance", JSON_TNUMBER, numbers, 2, 0) != 2 || numbers[2] != -1)
+	{
+		printf("more than n values written\n");
+		failures++;
+	}
+}
+
+int main()
+{
+	JSON* root = json_loadstring(str);
+	check(root);
+	json_destroy(root);
+
+	JSONDoc* doc = json_doc_loadstring(str);
+	check(json_doc_root(doc));
+	json_doc_destroy(doc);
+
+	printf("%d failures\n", failures);
+	mp_terminate();
+	return failures != 0;
+}
@@ -0,0 +1,83 @@
+#define LIBJSON_IMPLEMENTATION
+#define MP_IMPLEMENTATION
+#define MP_CHECK_FULL
+#include "magpie.h"
+#include "libjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Checks that the records of a document share their names and shapes, and that shared names of built trees aren't
+// freed
+
+int failures = 0;
+
+void expect(const char* what, int ok)
+{
+	if (!ok)
+	{
+		printf("%s\n", what);
+		failures++;
+	}
+}
+
+int main()
+{
+	// The last record spells its name with an escape and repeats a member
+	char* str = "[{\"name\": \"Emma\", \"age\": 19}, {\"age\": 21, \"name\": \"Liam\"}, "
+				"{\"na\\u006de\": \"Ava\", \"age\": 1, \"age\": 30}]";
+	JSONDoc* doc = json_doc_loadstring(str);
+	JSON* root = json_doc_root(doc);
+	JSON* first = json_get_element(root, 0);
+	JSON* last = json_get_element(root, 2);
+	const char* name = json_get_name(json_get_member(first, "name"));
+	expect("names are shared", name == json_get_name(json_get_member(last, "name")));
+
+	const char* age = json_doc_key(doc, "age");
+	expect("json_doc_key returns the shared name", age == json_get_name(json_get_member(first, "age")));
+	expect("duplicate members are replaced", json_get_member_integer(last, age) == 30);
+	expect("duplicate members keep their place",
+		   json_get_next(json_get_member(last, name)) == json_get_member(last, age));
+	expect("unknown names are returned as they are", strcmp(json_doc_key(doc, "balance"), "balance") == 0);
+
+	// age is the first member of the second record and the second member of the others
+	int slot = -1;
+	int64_t sum = 0;
+	for (JSON* it = json_get_elements(root); it; it = json_get_next(it))
+		sum += json_get_integer(json_get_member_cached(it, age, &slot));
+	expect("cached lookups find every member", sum == 19 + 21 + 30);
+	expect("cached lookups miss", json_get_member_cached(first, "balance", &slot) == NULL && slot == 1);
+	json_doc_destroy(doc);
+
+	JSONKeys* keys = json_keys_create();
+	name = json_keys_intern(keys, "name");
+	expect("equal names are interned once", name == json_keys_intern(keys, "name"));
+	JSON* people = json_create_array();
+	for (int i = 0; i < 16; i++)
+	{
+		JSON* person = json_create_object();
+		json_add_member_shared(person, name, json_create_string("Emma"));
+		json_add_member_shared(person, json_keys_intern(keys, "age"), json_create_number(i));
+		json_add_member(person, "balance", json_create_number(i * 10));
+		json_add_element(people, person);
+	}
+
+	// A replaced member keeps the shared name, and a popped member keeps it until added under a copied name
+	JSON* person = json_get_element(people, 3);
+	json_add_member(person, "name", json_create_string("Olivia"));
+	JSON* balance = json_pop_member(person, "balance");
+	json_add_member_shared(person, "balance", balance);
+	JSON* popped = json_pop_member(person, "name");
+	expect("popped members keep their shared name", json_get_name(popped) == name);
+	json_add_member(person, "first", popped);
+	char* written = json_tostring(person, JSON_COMPACT);
+	expect("members are replaced and moved", strcmp(written, "{\"age\":3,\"balance\":30,\"first\":\"Olivia\"}") == 0);
+	free(written);
+
+	json_destroy(people);
+	json_keys_destroy(keys);
+
+	printf("%d failures\n", failures);
+	mp_terminate();
+	return failures != 0;
+}
@@ -0,0 +1,134 @@
+#define LIBJSON_IMPLEMENTATION
+#define MP_IMPLEMENTATION
+#define MP_CHECK_FULL
+#include "magpie.h"
+#include "libjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Checks reading newline delimited json line by line, and that written records read back the same
+
+struct Record
+{
+	// The record written as compact json, NULL for an invalid line
+	const char* json;
+	size_t line;
+};
+
+// Blank and whitespace only lines, CRLF endings, an invalid line, and a last record without a newline
+const char* input = "{\"name\": \"Emma\", \"age\": 19}\r\n"
+					"\r\n"
+					"  \t \n"
+					"[1, 2\n"
+					"{\"name\": \"Li\\nam\"}\r\n"
+					"\n"
+					"  [true, null]  \r\n"
+					"42";
+
+const struct Record expected[] = {{"{\"name\":\"Emma\",\"age\":19}", 1},
+								  {NULL, 4},
+								  {"{\"name\":\"Li\\nam\"}", 5},
+								  {"[true,null]", 7},
+								  {"42", 8}};
+
+int failures = 0;
+
+// Collects what the writer writes
+struct Sink
+{
+	char* str;
+	size_t length;
+};
+
+int sink_write(void* ctx, const char* data, size_t len)
+{
+	struct Sink* sink = ctx;
+	sink->str = realloc(sink->str, sink->length + len + 1);
+	memcpy(sink->str + sink->length, data, len);
+	sink->length += len;
+	sink->str[sink->length] = '\0';
+	return 0;
+}
+
+// Reads all records of str and compares them with expected, writing the valid ones to writer if it's not NULL
+void check(const char* what, const char* str, const struct Record* records, size_t count, JSONLinesWriter* writer)
+{
+	JSONLines* lines = json_lines_openbuffer(str, strlen(str));
+	JSON* record;
+	size_t i = 0;
+	int result;
+	while ((result = json_lines_next(lines, &record)) != 0)
+	{
+		if (i == count)
+		{
+			printf("%s: more records than expected\n", what);
+			failures++;
+			break;
+		}
+		const struct Record* r = &records[i++];
+		if ((result == 1) != (r->json != NULL) || json_lines_line(lines) != r->line)
+		{
+			printf("%s: line %zu read as %d at line %zu\n", what, r->line, result, json_lines_line(lines));
+			failures++;
+			continue;
+		}
+		if (result == -1)
+		{
+			JSONError error;
+			json_lines_error(lines, &error);
+			if (error.code != JSON_ERROR_END || error.line != r->line)
+			{
+				printf("%s: line %zu has error %s at line %zu\n", what, r->line, json_error_string(error.code),
+					   error.line);
+				failures++;
+			}
+			continue;
+		}
+
+		char* written = json_tostring(record, JSON_COMPACT);
+		if (strcmp(written, r->json) != 0)
+		{
+			printf("%s: line %zu read as %s\n", what, r->line, written);
+			failures++;
+		}
+		free(written);
+		if (writer && json_lines_write(writer, record) != 0)
+			failures++;
+	}
+	if (i != count)
+	{
+		printf("%s: read %zu of %zu records\n", what, i, count);
+		failures++;
+	}
+	json_lines_close(lines);
+}
+
+int main()
+{
+	struct Sink sink = {0};
+	JSONLinesWriter* writer = json_lines_writer_create(sink_write, &sink);
+	check("input", input, expected, sizeof expected / sizeof *expected, writer);
+	if (json_lines_writer_close(writer) != 0)
+		failures++;
+
+	// The valid records are written one per line and read back the same
+	const struct Record rewritten[] = {{expected[0].json, 1}, {expected[2].json, 2}, {expected[3].json, 3},
+									   {expected[4].json, 4}};
+	if (sink.str == NULL || sink.str[sink.length - 1] != '\n')
+	{
+		printf("written records don't end with a newline\n");
+		failures++;
+	}
+	else
+		check("written", sink.str, rewritten, sizeof rewritten / sizeof *rewritten, NULL);
+	free(sink.str);
+
+	// Empty and blank input has no records
+	check("empty", "", NULL, 0, NULL);
+	check("blank", "\n\r\n  \n", NULL, 0, NULL);
+
+	printf("%d failures\n", failures);
+	mp_terminate();
+	return failures != 0;
+}
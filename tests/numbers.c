@@ -0,0 +1,169 @@
+#define LIBJSON_IMPLEMENTATION
+#define MP_IMPLEMENTATION
+#define MP_CHECK_FULL
+#include "magpie.h"
+#include "libjson.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Compares the parsed value of every number against strtod, bit for bit
+
+const char* cases[] = {"0",
+					   "-0",
+					   "1",
+					   "-1",
+					   "0.1",
+					   "0.2",
+					   "0.3",
+					   "1e-5",
+					   "1E+5",
+					   "123.456e-2",
+					   "1.7976931348623157e308",
+					   "1.7976931348623158e308",
+					   "1.8e308",
+					   "2.2250738585072014e-308",
+					   "2.2250738585072011e-308",
+					   "4.9406564584124654e-324",
+					   "2.4703282292062327e-324",
+					   "2.4703282292062328e-324",
+					   "1e-400",
+					   "1e400",
+					   "9007199254740993",
+					   "9007199254740993.0",
+					   "18446744073709551615",
+					   "18446744073709551616",
+					   "9223372036854775808",
+					   "-9223372036854775809",
+					   "0.000000000000000000000000000000000000001",
+					   "7.3177701707893310e+15",
+					   "2.2250738585072012e-308",
+					   "9007199254740992.5",
+					   "9007199254740993.0000000000000000000000001",
+					   "1.00000000000000011102230246251565404236316680908203125",
+					   "1.00000000000000011102230246251565404236316680908203124",
+					   "1.00000000000000011102230246251565404236316680908203126",
+					   "3.14159265358979323846264338327950288419716939937510",
+					   "123456789012345678901234567890e-10"};
+
+int failures = 0;
+
+void check(const char* str)
+{
+	JSON* num = json_loadstring((char*)str);
+	double expected = strtod(str, NULL);
+	double got = num ? json_get_number(num) : 0;
+	if (num == NULL || memcmp(&expected, &got, sizeof got) != 0)
+	{
+		printf("%s: expected %.17g, got %.17g\n", str, expected, got);
+		failures++;
+	}
+	if (num)
+		json_destroy(num);
+}
+
+void check_integer(const char* str, int64_t expected)
+{
+	JSON* num = json_loadstring((char*)str);
+	if (num == NULL || json_get_integer(num) != expected)
+	{
+		printf("%s: expected integer %lld\n", str, (long long)expected);
+		failures++;
+	}
+	if (num)
+		json_destroy(num);
+}
+
+// Random 64 bits
+uint64_t rand64()
+{
+	uint64_t r = 0;
+	for (int i = 0; i < 4; i++)
+		r = r << 16 | (rand() & 0xFFFF);
+	return r;
+}
+
+int main()
+{
+	char buf[512];
+
+	for (size_t i = 0; i < sizeof cases / sizeof *cases; i++)
+		check(cases[i]);
+
+	// Every finite double round trips through its shortest and longer representations
+	for (int i = 0; i < 100000; i++)
+	{
+		uint64_t bits = rand64();
+		double d;
+		memcpy(&d, &bits, sizeof d);
+		if (!isfinite(d))
+			continue;
+		snprintf(buf, sizeof buf, "%.17g", d);
+		check(buf);
+		snprintf(buf, sizeof buf, "%.*e", rand() % 25, d);
+		check(buf);
+	}
+
+	// Random digit strings, including more digits than fit in the mantissa
+	for (int i = 0; i < 100000; i++)
+	{
+		int len = 0;
+		if (rand() % 2)
+			buf[len++] = '-';
+		int digits = rand() % 40 + 1;
+		buf[len++] = '1' + rand() % 9;
+		for (int j = 1; j < digits; j++)
+			buf[len++] = '0' + rand() % 10;
+		if (rand() % 2)
+		{
+			buf[len++] = '.';
+			for (int j = rand() % 30; j >= 0; j--)
+				buf[len++] = '0' + rand() % 10;
+		}
+		len += snprintf(buf + len, sizeof buf - len, "e%d", rand() % 700 - 350);
+		check(buf);
+	}
+
+	// Integers are kept exact
+	check_integer("9007199254740993", 9007199254740993LL);
+	check_integer("9223372036854775807", INT64_MAX);
+	check_integer("-9223372036854775808", INT64_MIN);
+	check_integer("-42", -42);
+
+	// Other numbers are truncated, and saturate beyond the range of int64_t
+	check_integer("1.9", 1);
+	check_integer("-1.9e0", -1);
+	check_integer("1e300", INT64_MAX);
+	check_integer("-1e300", INT64_MIN);
+	check_integer("9223372036854775808", INT64_MAX);
+	check_integer("-9223372036854775809", INT64_MIN);
+	JSON* created[] = {json_create_number(1e300), json_create_number(-INFINITY), json_create_number(NAN)};
+	int64_t expected[] = {INT64_MAX, INT64_MIN, 0};
+	for (int i = 0; i < 3; i++)
+	{
+		if (json_get_integer(created[i]) != expected[i])
+		{
+			printf("created number %d: expected integer %lld\n", i, (long long)expected[i]);
+			failures++;
+		}
+		json_destroy(created[i]);
+	}
+
+	// Invalid numbers
+	const char* invalid[] = {"-", "1.", ".5", "1e", "1e+", "[01]", "--1", "+1"};
+	for (size_t i = 0; i < sizeof invalid / sizeof *invalid; i++)
+	{
+		JSON* num = json_loadstring((char*)invalid[i]);
+		if (num)
+		{
+			printf("%s: expected invalid number\n", invalid[i]);
+			failures++;
+			json_destroy(num);
+		}
+	}
+
+	printf("%d failures\n", failures);
+	mp_terminate();
+	return failures != 0;
+}
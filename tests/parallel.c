@@ -0,0 +1,141 @@
+// Small chunks, so that large arrays and objects are split between many threads
+#define JSON_BATCH_CHUNK 1024
+// Counts the ranges parsed, which shows the input was split rather than loaded on one thread after the scan failed
+#define JSON_STATS
+#define LIBJSON_IMPLEMENTATION
+#define MP_IMPLEMENTATION
+#define MP_CHECK_FULL
+#include "magpie.h"
+#include "libjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Checks that loading a large array or object on several threads builds the same tree as loading it on one
+
+int failures = 0;
+
+// Structural characters, escaped quotes, and runs of backslashes, which the scans must not take for json outside of
+// strings wherever a range starts
+const char* pieces[] = {",", "]", "}", "[", "{", ":", " ", "a", "\\n", "\\u00e9", "\\\"", "\\\\", "\\\\\\\"",
+						"\\\\\\\\\\\"", "\\\\\\\\\\\\\\\\"};
+
+// Appends a random string
+size_t add_string(char* str, size_t len)
+{
+	str[len++] = '"';
+	for (int i = rand() % 12; i > 0; i--)
+		len += sprintf(str + len, "%s", pieces[rand() % (sizeof pieces / sizeof *pieces)]);
+	str[len++] = '"';
+	return len;
+}
+
+// Appends a random value, with arrays and objects nested up to depth
+size_t add_value(char* str, size_t len, int depth)
+{
+	switch (depth > 0 ? rand() % 6 : rand() % 3)
+	{
+	case 0:
+		return len + sprintf(str + len, "%d.%de%d", rand() % 1000 - 500, rand() % 100, rand() % 20 - 10);
+	case 1:
+		return add_string(str, len);
+	case 2:
+		return len + sprintf(str + len, rand() % 2 ? "true" : "null");
+	case 3:
+	case 4:
+		str[len++] = '[';
+		for (int i = rand() % 4; i >= 0; i--)
+		{
+			len = add_value(str, len, depth - 1);
+			if (i)
+				str[len++] = ',';
+		}
+		str[len++] = ']';
+		return len;
+	default:
+		// Objects repeat a member, which replaces the value of the first one
+		len += sprintf(str + len, "{\"a\": ");
+		len = add_value(str, len, depth - 1);
+		len += sprintf(str + len, ", \"b\": [], \"a\": ");
+		len = add_value(str, len, depth - 1);
+		str[len++] = '}';
+		return len;
+	}
+}
+
+// Appends an array or object of at least size bytes
+// The members of the object repeat every 97 names, some spelled with escape sequences, so that duplicates are found in
+// different ranges
+size_t add_root(char* str, size_t len, size_t size, int object)
+{
+	size_t start = len;
+	str[len++] = object ? '{' : '[';
+	for (int i = 0; len - start < size; i++)
+	{
+		if (i)
+			len += sprintf(str + len, rand() % 2 ? ",\n" : ", ");
+		if (object)
+			len += sprintf(str + len, rand() % 4 ? "\"key%d\": " : "\"ke\\u0079%d\": ", i % 97);
+		len = add_value(str, len, 3);
+	}
+	str[len++] = object ? '}' : ']';
+	return len;
+}
+
+void check(const char* what, const char* str, size_t len, int threads)
+{
+	JSON* expected = json_loadbuffer(str, len);
+	json_stats_reset();
+	JSON* loaded = json_loadbuffer_parallel(str, len, threads);
+	if (threads > 1 && json_stats_get().parses < 2)
+	{
+		printf("%s on %d threads: loaded on one thread\n", what, threads);
+		failures++;
+	}
+	char* expected_str = expected ? json_tostring(expected, JSON_COMPACT) : NULL;
+	char* loaded_str = loaded ? json_tostring(loaded, JSON_COMPACT) : NULL;
+	if (expected_str == NULL || loaded_str == NULL || strcmp(expected_str, loaded_str) != 0)
+	{
+		printf("%s on %d threads: %s\n", what, threads, loaded ? "the trees differ" : "not loaded");
+		failures++;
+	}
+	free(expected_str);
+	free(loaded_str);
+	if (expected)
+		json_destroy(expected);
+	if (loaded)
+		json_destroy(loaded);
+}
+
+int main()
+{
+	// Whitespace after the opening bracket moves the ranges of the threads to every character of a string
+	size_t shift = 64;
+	size_t size = 32 * JSON_BATCH_CHUNK;
+	char* buf = malloc(shift + size * 2);
+	memset(buf, ' ', shift);
+	char* str = buf + shift;
+	srand(11);
+
+	for (int object = 0; object <= 1; object++)
+	{
+		const char* what = object ? "object" : "array";
+		size_t len = add_root(str, 0, size, object);
+		for (int threads = 1; threads <= 8; threads++)
+			check(what, str, len, threads);
+		for (size_t i = 1; i <= shift; i++)
+		{
+			char* open = str - i;
+			open[0] = open[1];
+			open[1] = ' ';
+			check(what, open, len + i, 3);
+			check(what, open, len + i, 7);
+		}
+		memset(buf, ' ', shift);
+	}
+
+	free(buf);
+	printf("%d failures\n", failures);
+	mp_terminate();
+	return failures != 0;
+}
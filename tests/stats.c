@@ -0,0 +1,60 @@
+#define JSON_STATS
+#define LIBJSON_IMPLEMENTATION
+#define MP_IMPLEMENTATION
+#define MP_CHECK_FULL
+#include "magpie.h"
+#include "libjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Checks what JSON_STATS counts for loading and writing a known document
+
+int failures = 0;
+
+void expect(const char* what, uint64_t got, uint64_t expected)
+{
+	if (got != expected)
+	{
+		printf("%s: expected %llu, got %llu\n", what, (unsigned long long)expected, (unsigned long long)got);
+		failures++;
+	}
+}
+
+int main()
+{
+	char* str = "{\"name\": \"Julia\", \"tags\": [\"a\\nb\", \"c\"], \"age\": 19}";
+
+	json_stats_reset();
+	JSON* root = json_loadstring(str);
+	JSONStats stats = json_stats_get();
+	// The root, the three members, and the two elements
+	expect("nodes", stats.nodes.allocs, 6);
+	expect("children", stats.children.allocs, 2);
+	expect("names", stats.names.allocs, 3);
+	expect("names bytes", stats.names.bytes, strlen("name") + strlen("tags") + strlen("age") + 3);
+	expect("strings", stats.strings.allocs, 3);
+	expect("parses", stats.parses, 1);
+	expect("parse bytes", stats.parse_bytes, strlen(str));
+
+	json_stats_reset();
+	char* written = json_tostring(root, JSON_COMPACT);
+	stats = json_stats_get();
+	expect("writes", stats.writes, 1);
+	expect("write bytes", stats.write_bytes, strlen(written));
+	expect("nodes written", stats.nodes.allocs, 0);
+	free(written);
+
+	// A document allocates its nodes from a single block sized after the input
+	json_stats_reset();
+	JSONDoc* doc = json_doc_loadstring(str);
+	stats = json_stats_get();
+	expect("document nodes", stats.nodes.allocs, 6);
+	expect("document blocks", stats.arenas.allocs, 1);
+	json_doc_destroy(doc);
+
+	json_destroy(root);
+	printf("%d failures\n", failures);
+	mp_terminate();
+	return failures != 0;
+}
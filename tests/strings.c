@@ -0,0 +1,89 @@
+#define LIBJSON_IMPLEMENTATION
+#define MP_IMPLEMENTATION
+#define MP_CHECK_FULL
+#include "magpie.h"
+#include "libjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Checks unicode escape sequences against their UTF-8, and writing them back with JSON_ASCII
+
+struct Case
+{
+	const char* json;
+	const char* value;
+};
+
+const struct Case cases[] = {{"\"\\u0041\"", "A"},
+							 {"\"x\\u00e9y\"", "x\xc3\xa9y"},
+							 {"\"\\u20AC\"", "\xe2\x82\xac"},
+							 {"\"\\uD83D\\uDE00!\"", "\xf0\x9f\x98\x80!"},
+							 {"\"\\udbff\\udfff\"", "\xf4\x8f\xbf\xbf"},
+							 {"\"\\/\\b\\f\\n\\r\\t\\\"\\\\\"", "/\b\f\n\r\t\"\\"},
+							 {"\"caf\xc3\xa9\"", "caf\xc3\xa9"}};
+
+// Lone surrogates, a surrogate pair missing its low half, and bad hex digits
+const char* invalid[] = {"\"\\uD83D\"", "\"\\uD83Dx\"", "\"\\uD83D\\u0041\"",
+						 "\"\\uDE00\"", "\"\\u12\"", "\"\\u12G4\""};
+
+int failures = 0;
+
+int main()
+{
+	for (size_t i = 0; i < sizeof cases / sizeof *cases; i++)
+	{
+		JSON* str = json_loadstring((char*)cases[i].json);
+		if (str == NULL || strcmp(json_get_string(str), cases[i].value) != 0)
+		{
+			printf("%s: expected %s\n", cases[i].json, cases[i].value);
+			failures++;
+		}
+
+		// Every character outside ASCII is escaped and reads back the same
+		char* ascii = str ? json_tostring(str, JSON_ASCII) : NULL;
+		JSON* back = ascii ? json_loadstring(ascii) : NULL;
+		for (const char* p = ascii; p && *p; p++)
+			if ((unsigned char)*p >= 0x80)
+			{
+				printf("%s: not ASCII\n", ascii);
+				failures++;
+				break;
+			}
+		if (back == NULL || strcmp(json_get_string(back), cases[i].value) != 0)
+		{
+			printf("%s: does not read back\n", ascii ? ascii : cases[i].json);
+			failures++;
+		}
+		free(ascii);
+		if (back)
+			json_destroy(back);
+		if (str)
+			json_destroy(str);
+	}
+
+	for (size_t i = 0; i < sizeof invalid / sizeof *invalid; i++)
+	{
+		JSON* str = json_loadstring((char*)invalid[i]);
+		if (str)
+		{
+			printf("%s: expected invalid string\n", invalid[i]);
+			failures++;
+			json_destroy(str);
+		}
+	}
+
+	JSON* smiley = json_create_string("\xf0\x9f\x98\x80");
+	char* escaped = json_tostring(smiley, JSON_ASCII);
+	if (strcmp(escaped, "\"\\ud83d\\ude00\"") != 0)
+	{
+		printf("%s: expected a surrogate pair\n", escaped);
+		failures++;
+	}
+	free(escaped);
+	json_destroy(smiley);
+
+	printf("%d failures\n", failures);
+	mp_terminate();
+	return failures != 0;
+}
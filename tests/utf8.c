@@ -0,0 +1,105 @@
+#define JSON_VALIDATE_UTF8
+#define LIBJSON_IMPLEMENTATION
+#define MP_IMPLEMENTATION
+#define MP_CHECK_FULL
+#include "magpie.h"
+#include "libjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Checks that JSON_VALIDATE_UTF8 rejects invalid UTF-8 at the right character, whether it interrupts a run of ASCII
+// that is skipped at once or follows one, and accepts the valid characters next to them
+
+struct Case
+{
+	const char* bytes;
+	// Where the invalid sequence starts in bytes
+	size_t invalid;
+};
+
+const struct Case invalid[] = {// Truncated sequences
+							   {"\xc3", 0},
+							   {"\xe2\x82", 0},
+							   {"\xf0\x9f\x98", 0},
+							   // Overlong forms
+							   {"\xc0\xaf", 0},
+							   {"\xc1\xbf", 0},
+							   {"\xe0\x80\xaf", 0},
+							   {"\xe0\x9f\xbf", 0},
+							   {"\xf0\x80\x80\xaf", 0},
+							   {"\xf0\x8f\xbf\xbf", 0},
+							   // Encoded surrogates
+							   {"\xed\xa0\x80", 0},
+							   {"\xed\xbf\xbf", 0},
+							   // Above U+10FFFF
+							   {"\xf4\x90\x80\x80", 0},
+							   {"\xf5\x80\x80\x80", 0},
+							   {"\xff", 0},
+							   // Bare continuation bytes
+							   {"\x80", 0},
+							   {"\xbf", 0},
+							   {"\xc3\xa9\x80", 2}};
+
+// The lowest and highest characters of every length, and those around the surrogates
+const char* valid[] = {"\xc2\x80",		   "\xdf\xbf",	   "\xe0\xa0\x80", "\xed\x9f\xbf",
+					   "\xee\x80\x80",	   "\xef\xbf\xbf", "\xf0\x90\x80\x80", "\xf4\x8f\xbf\xbf"};
+
+const char* ascii = "abcdefghijklmnop";
+
+int failures = 0;
+
+// Loads a string holding bytes, after prefix ASCII characters and followed by 16 more
+// Returns the error, with the offset made relative to bytes
+JSONError load(const char* bytes, size_t prefix, int escape)
+{
+	char str[64];
+	size_t len = (size_t)snprintf(str, sizeof str, "\"%.*s%s%s%s\"", (int)prefix, ascii, bytes, ascii,
+								  escape ? "\\n" : "");
+	JSONError error = {0};
+	JSON* root = json_loadbuffer_error(str, len, &error);
+	if (root)
+		json_destroy(root);
+	error.offset -= 1 + prefix;
+	return error;
+}
+
+int main()
+{
+	// Inside a run of 16 ASCII characters and right after one
+	size_t prefixes[] = {0, 5, 16};
+	for (size_t p = 0; p < sizeof prefixes / sizeof *prefixes; p++)
+	{
+		for (size_t i = 0; i < sizeof invalid / sizeof *invalid; i++)
+		{
+			JSONError error = load(invalid[i].bytes, prefixes[p], 0);
+			if (error.code != JSON_ERROR_UTF8 || error.offset != invalid[i].invalid)
+			{
+				printf("invalid case %zu after %zu characters: got %s at %zu\n", i, prefixes[p],
+					   json_error_string(error.code), error.offset);
+				failures++;
+			}
+
+			// Unescaped strings are rejected as a whole
+			if (load(invalid[i].bytes, prefixes[p], 1).code != JSON_ERROR_UTF8)
+			{
+				printf("invalid case %zu after %zu characters with an escape sequence is accepted\n", i, prefixes[p]);
+				failures++;
+			}
+		}
+
+		for (size_t i = 0; i < sizeof valid / sizeof *valid; i++)
+		{
+			if (load(valid[i], prefixes[p], 0).code != JSON_ERROR_NONE ||
+				load(valid[i], prefixes[p], 1).code != JSON_ERROR_NONE)
+			{
+				printf("valid case %zu after %zu characters is rejected\n", i, prefixes[p]);
+				failures++;
+			}
+		}
+	}
+
+	printf("%d failures\n", failures);
+	mp_terminate();
+	return failures != 0;
+}
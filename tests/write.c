@@ -0,0 +1,95 @@
+#define LIBJSON_IMPLEMENTATION
+#define MP_IMPLEMENTATION
+#define MP_CHECK_FULL
+#include "magpie.h"
+#include "libjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Checks that writing through a JSONWriteFn gives the same json as json_tostring, and that failed writes are reported
+
+// Collects what is written, and fails from the write numbered fail_after on if it's set
+struct Sink
+{
+	char* str;
+	size_t length;
+	size_t calls;
+	int fail_after;
+};
+
+int failures = 0;
+
+int sink_write(void* ctx, const char* data, size_t len)
+{
+	struct Sink* sink = ctx;
+	if (sink->fail_after && sink->calls + 1 >= (size_t)sink->fail_after)
+		return -1;
+	if (len > JSON_WRITE_BUFFER)
+	{
+		printf("wrote %zu bytes at once\n", len);
+		failures++;
+	}
+	sink->str = realloc(sink->str, sink->length + len + 1);
+	memcpy(sink->str + sink->length, data, len);
+	sink->length += len;
+	sink->str[sink->length] = '\0';
+	sink->calls++;
+	return 0;
+}
+
+int main()
+{
+	// Several buffers of records, with escapes and characters outside ASCII
+	JSON* root = json_create_array();
+	for (int i = 0; i < 4000; i++)
+	{
+		JSON* record = json_create_object();
+		json_add_member(record, "name", json_create_string(i % 2 ? "Zo\xc3\xab \"Z\"" : "Liam\n"));
+		json_add_member(record, "balance", json_create_number(i * 1.25));
+		JSON* tags = json_create_array();
+		json_add_element(tags, json_create_integer(i));
+		json_add_member(record, "tags", tags);
+		json_add_element(root, record);
+	}
+
+	int formats[] = {JSON_COMPACT, JSON_FORMAT, JSON_FORMAT | JSON_ASCII};
+	for (int i = 0; i < 3; i++)
+	{
+		char* expected = json_tostring(root, formats[i]);
+		struct Sink sink = {0};
+		int result = json_write_to(root, sink_write, &sink, formats[i]);
+		if (result != 0 || sink.calls < 2 || sink.str == NULL || strcmp(sink.str, expected) != 0)
+		{
+			printf("format %d: written json differs\n", formats[i]);
+			failures++;
+		}
+		free(sink.str);
+		free(expected);
+	}
+
+	// Failing the first write, a later one, and the final flush of a small document
+	for (int fail_after = 1; fail_after <= 3; fail_after++)
+	{
+		struct Sink sink = {.fail_after = fail_after};
+		if (json_write_to(root, sink_write, &sink, JSON_COMPACT) != -1)
+		{
+			printf("failing write %d: expected -1\n", fail_after);
+			failures++;
+		}
+		free(sink.str);
+	}
+	JSON* small = json_create_number(1);
+	struct Sink sink = {.fail_after = 1};
+	if (json_write_to(small, sink_write, &sink, JSON_COMPACT) != -1)
+	{
+		printf("failing flush: expected -1\n");
+		failures++;
+	}
+	json_destroy(small);
+
+	json_destroy(root);
+	printf("%d failures\n", failures);
+	mp_terminate();
+	return failures != 0;
+}